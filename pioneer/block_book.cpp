@@ -0,0 +1,935 @@
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <queue>
+#include "utils/bitstream.h"
+#include "block_book.h"
+
+using namespace std;
+
+constexpr size_t MOVE_RECORD_SIZE = sizeof(int16_t) + sizeof(uint32_t);
+
+bool isBlockBook(const char* data, size_t size)
+{
+    return size >= sizeof(BlockHeader) && memcmp(data, BLOCK_BOOK_MAGIC, sizeof(BLOCK_BOOK_MAGIC)) == 0;
+}
+
+BlockBookWriter::BlockBookWriter() : pendingBits(0), current(), offset(0), records(0), blockSize(0), flags(0) {}
+
+static uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Rice parameter for keys spread evenly over 'span'
+static unsigned riceParameter(uint64_t span, size_t keys)
+{
+    uint64_t mean = keys > 0 ? span / keys : 0;
+    return mean > 0 ? bitWidth(mean) - 1 : 0;
+}
+
+static size_t packedMoveCount(const MoveList& entries)
+{
+    return min<size_t>(entries.size(), UINT8_MAX);
+}
+
+// Everything of a packed record but its key
+static size_t packedRecordBits(const Board& board, const MoveList& entries, bool keysOnly)
+{
+    size_t count = packedMoveCount(entries);
+    size_t bits = gammaBits(count + 1);
+
+    if (!keysOnly)
+    {
+        bits += 64;
+
+        for (size_t i = 0; i < 64; i++)
+        {
+            bits += board.representation()[i] != NN ? 4 : 0;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint16_t raw = static_cast<uint16_t>(entries[i].move.encode());
+        bits += (raw & 0xC0C0) != 0 ? 17 : 13;
+        bits += i == 0 ? gammaBits(uint64_t(entries[i].count) + 1)
+            : gammaBits(zigzag(int64_t(entries[i - 1].count) - entries[i].count) + 1);
+    }
+
+    return bits;
+}
+
+static void packRecords(const vector<PagedRecord>& records, uint64_t firstKey, bool keysOnly, vector<char>& out)
+{
+    unsigned k = riceParameter(records.back().key - firstKey, records.size());
+    out.push_back(static_cast<char>(k));
+
+    BitWriter bits(out);
+    uint64_t previous = firstKey;
+
+    for (const auto& record : records)
+    {
+        bits.putRice(record.key - previous, k);
+        previous = record.key;
+
+        if (!keysOnly)
+        {
+            const char* squares = record.board.representation();
+            uint64_t occupancy = 0;
+
+            for (size_t i = 0; i < 64; i++)
+            {
+                occupancy |= uint64_t(squares[i] != NN) << i;
+            }
+
+            bits.put(occupancy, 64);
+
+            for (size_t i = 0; i < 64; i++)
+            {
+                if (squares[i] != NN)
+                {
+                    bits.put(static_cast<uint64_t>(squares[i]), 4);
+                }
+            }
+        }
+
+        size_t count = packedMoveCount(record.entries);
+        bits.putGamma(count + 1);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint16_t raw = static_cast<uint16_t>(record.entries[i].move.encode());
+            uint16_t extra = ((raw >> 6) & 0b11) | ((raw >> 12) & 0b1100);
+
+            bits.put((raw >> 8) & 0x3F, 6);
+            bits.put(raw & 0x3F, 6);
+            bits.put(extra != 0, 1);
+
+            if (extra != 0)
+            {
+                bits.put(extra, 4);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            bits.putGamma(i == 0 ? uint64_t(record.entries[0].count) + 1
+                : zigzag(int64_t(record.entries[i - 1].count) - record.entries[i].count) + 1);
+        }
+    }
+
+    bits.finish();
+}
+
+// Stops early on a stream that runs short or a move count no writer emits;
+// the CRC has already been checked by then, so that only happens to a writer
+// bug.
+static void unpackRecords(const char* in, const char* end, uint64_t firstKey, bool keysOnly, PagedBlock& records)
+{
+    if (in == end)
+    {
+        records.clear();
+        return;
+    }
+
+    unsigned k = static_cast<uint8_t>(*in++);
+    BitReader bits(in, end);
+    uint64_t previous = firstKey;
+
+    for (size_t r = 0; r < records.size(); r++)
+    {
+        PagedRecord& record = records[r];
+        record.key = previous + bits.getRice(k);
+        previous = record.key;
+
+        if (!keysOnly)
+        {
+            // Every nibble starts out empty; only occupied squares are read
+            uint64_t occupancy = bits.get(64);
+            char enc[32];
+            memset(enc, (NN << 4) | NN, sizeof(enc));
+
+            for (; occupancy != 0; occupancy &= occupancy - 1)
+            {
+                unsigned square = static_cast<unsigned>(countr_zero(occupancy));
+                unsigned shift = square % 2 == 0 ? 4 : 0;
+                enc[square / 2] = static_cast<char>((enc[square / 2] & ~(0xF << shift)) | (bits.get(4) << shift));
+            }
+
+            record.board.decode(enc);
+        }
+
+        size_t count = bits.getGamma() - 1;
+
+        if (!bits.ok() || count > UINT8_MAX)
+        {
+            records.resize(r);
+            return;
+        }
+
+        record.entries.resize(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint16_t from = static_cast<uint16_t>(bits.get(6));
+            uint16_t to = static_cast<uint16_t>(bits.get(6));
+            uint16_t extra = bits.get(1) ? static_cast<uint16_t>(bits.get(4)) : 0;
+            uint16_t raw = (from << 8) | to | ((extra & 0b11) << 6) | ((extra & 0b1100) << 12);
+
+            record.entries[i].move = Move::decode(static_cast<int16_t>(raw));
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint64_t code = bits.getGamma() - 1;
+            record.entries[i].count = i == 0 ? static_cast<uint32_t>(code)
+                : static_cast<uint32_t>(int64_t(record.entries[i - 1].count) - unzigzag(code));
+        }
+
+        if (!bits.ok())
+        {
+            records.resize(r);
+            return;
+        }
+    }
+}
+
+bool BlockBookWriter::open(const string& path, size_t variations, size_t moves, uint32_t _blockSize, uint16_t _flags, bool direct, uint32_t generation)
+{
+    blockSize = _blockSize;
+    flags = _flags;
+    index.clear();
+    keys.clear();
+    block.clear();
+    pending.clear();
+    pendingBits = 0;
+    block.reserve(blockSize);
+    records = 0;
+
+    BlockHeader header = {};
+    memcpy(header.magic, BLOCK_BOOK_MAGIC, sizeof(header.magic));
+    header.version = BLOCK_BOOK_VERSION;
+    header.flags = flags;
+    header.blockSize = blockSize;
+    header.generation = generation;
+    header.variations = variations;
+    header.moves = moves;
+
+    offset = sizeof(header);
+    return file.open(path, direct) && file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool BlockBookWriter::flushBlock()
+{
+    if (!pending.empty())
+    {
+        packRecords(pending, current.firstKey, (flags & BLOCK_KEYS_ONLY) != 0, block);
+        pending.clear();
+        pendingBits = 0;
+    }
+
+    if (block.empty())
+    {
+        return true;
+    }
+
+    current.offset = offset;
+    current.size = static_cast<uint32_t>(block.size());
+    index.push_back(current);
+
+    uint32_t checksum = crc32c(block.data(), block.size());
+
+    offset += block.size() + sizeof(checksum);
+    bool ok = file.write(block.data(), block.size())
+        && file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+
+    block.clear();
+    current = BlockIndexEntry();
+    return ok;
+}
+
+// Records must arrive in ascending key order and never straddle a block.
+bool BlockBookWriter::add(uint64_t key, const Board& board, const MoveList& entries)
+{
+    keys.push_back(key);
+
+    if (flags & BLOCK_PACKED)
+    {
+        return addPacked(key, board, entries);
+    }
+
+    size_t count = min<size_t>(entries.size(), UINT8_MAX);
+    size_t boardSize = (flags & BLOCK_KEYS_ONLY) ? 0 : 32;
+    size_t size = sizeof(key) + boardSize + 1 + count * MOVE_RECORD_SIZE;
+
+    if (!block.empty() && block.size() + size > blockSize && !flushBlock())
+    {
+        return false;
+    }
+
+    if (block.empty())
+    {
+        current.firstKey = key;
+    }
+
+    size_t at = block.size();
+    block.resize(at + size);
+    char* out = block.data() + at;
+
+    memcpy(out, &key, sizeof(key));
+    out += sizeof(key);
+
+    if (boardSize > 0)
+    {
+        board.encode(out);
+        out += boardSize;
+    }
+
+    *out++ = static_cast<char>(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int16_t move = entries[i].move.encode();
+        uint32_t moveCount = entries[i].count;
+
+        memcpy(out, &move, sizeof(move));
+        memcpy(out + sizeof(move), &moveCount, sizeof(moveCount));
+        out += MOVE_RECORD_SIZE;
+    }
+
+    current.lastKey = key;
+    current.records += 1;
+    records += 1;
+    return true;
+}
+
+// Packed records are held until the block is flushed, because the Rice
+// parameter depends on all of the block's keys. The block is closed when the
+// estimated size, with keys costed at the parameter their spread suggests,
+// would pass the target.
+bool BlockBookWriter::addPacked(uint64_t key, const Board& board, const MoveList& entries)
+{
+    bool keysOnly = (flags & BLOCK_KEYS_ONLY) != 0;
+    size_t bits = packedRecordBits(board, entries, keysOnly);
+
+    if (!pending.empty())
+    {
+        size_t keys = pending.size() + 1;
+        size_t keyBits = keys * (riceParameter(key - current.firstKey, keys) + 2);
+
+        if (8 + keyBits + pendingBits + bits > size_t(blockSize) * 8 && !flushBlock())
+        {
+            return false;
+        }
+    }
+
+    if (pending.empty())
+    {
+        current.firstKey = key;
+    }
+
+    pending.push_back({ key, board, MoveList(entries.begin(), entries.begin() + packedMoveCount(entries)) });
+    pendingBits += bits;
+
+    current.lastKey = key;
+    current.records += 1;
+    records += 1;
+    return true;
+}
+
+// Sized for the records actually written, so it is only built at close
+bool BlockBookWriter::writeFilter()
+{
+    BloomFilter filter(keys.size(), BLOCK_FILTER_FP_RATE);
+
+    for (uint64_t key : keys)
+    {
+        filter.add(key);
+    }
+
+    keys.clear();
+    keys.shrink_to_fit();
+
+    const vector<uint64_t>& words = filter.words();
+    size_t bytes = words.size() * sizeof(uint64_t);
+
+    BlockFilterTrailer trailer = {};
+    trailer.bitCount = filter.size();
+    trailer.hashes = filter.hashCount();
+    trailer.checksum = crc32c(words.data(), bytes);
+
+    offset += bytes + sizeof(trailer);
+    return file.write(reinterpret_cast<const char*>(words.data()), bytes)
+        && file.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+}
+
+bool BlockBookWriter::close(bool sync)
+{
+    bool ok = flushBlock() && writeFilter();
+
+    BlockFooter footer = {};
+    footer.indexOffset = offset;
+    footer.blockCount = index.size();
+    footer.recordCount = records;
+    memcpy(footer.magic, BLOCK_BOOK_MAGIC, sizeof(footer.magic));
+    footer.indexChecksum = crc32c(index.data(), index.size() * sizeof(BlockIndexEntry));
+
+    ok = ok && file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(BlockIndexEntry));
+    ok = ok && file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+    return file.close(sync) && ok;
+}
+
+BlockBookReader::BlockBookReader() : header(), recordCount(0), cacheBlocks(DEFAULT_CACHE_BLOCKS) {}
+
+// Only the header, footer, key filter and block index are read here; block
+// bodies are left to the page cache until a probe touches them.
+bool BlockBookReader::open(const string& path, size_t _cacheBlocks, HugePages hugePages)
+{
+    cacheBlocks = _cacheBlocks;
+
+    if (!file.open(path, hugePages) || !isBlockBook(file.data(), file.size())
+        || file.size() < sizeof(BlockHeader) + sizeof(BlockFooter))
+    {
+        return false;
+    }
+
+    BlockFooter footer;
+    memcpy(&header, file.data(), sizeof(header));
+    memcpy(&footer, file.data() + file.size() - sizeof(footer), sizeof(footer));
+
+    // The block count is bounded before it is multiplied, so a corrupt
+    // footer cannot wrap the size check
+    if (header.version < BLOCK_BOOK_MIN_VERSION || header.version > BLOCK_BOOK_VERSION
+        || memcmp(footer.magic, BLOCK_BOOK_MAGIC, sizeof(footer.magic)) != 0
+        || footer.blockCount > (file.size() - sizeof(footer)) / sizeof(BlockIndexEntry)
+        || footer.indexOffset != file.size() - sizeof(footer) - footer.blockCount * sizeof(BlockIndexEntry))
+    {
+        return false;
+    }
+
+    index.resize(footer.blockCount);
+    memcpy(index.data(), file.data() + footer.indexOffset, footer.blockCount * sizeof(BlockIndexEntry));
+    recordCount = footer.recordCount;
+
+    if (hasChecksums() && crc32c(index.data(), index.size() * sizeof(BlockIndexEntry)) != footer.indexChecksum)
+    {
+        return false;
+    }
+
+    // Blocks end where the filter starts, or at the index without one
+    uint64_t blocksEnd = footer.indexOffset;
+    filter = BloomFilter();
+
+    if (header.version >= 5)
+    {
+        BlockFilterTrailer filterTrailer;
+
+        if (footer.indexOffset < sizeof(BlockHeader) + sizeof(filterTrailer))
+        {
+            return false;
+        }
+
+        memcpy(&filterTrailer, file.data() + footer.indexOffset - sizeof(filterTrailer), sizeof(filterTrailer));
+
+        uint64_t words = filterTrailer.bitCount / 64 + (filterTrailer.bitCount % 64 != 0);
+        uint64_t room = (footer.indexOffset - sizeof(BlockHeader) - sizeof(filterTrailer)) / sizeof(uint64_t);
+
+        if (filterTrailer.bitCount == 0 || filterTrailer.hashes == 0 || words > room)
+        {
+            return false;
+        }
+
+        blocksEnd = footer.indexOffset - sizeof(filterTrailer) - words * sizeof(uint64_t);
+
+        vector<uint64_t> bits(words);
+        memcpy(bits.data(), file.data() + blocksEnd, words * sizeof(uint64_t));
+
+        if (crc32c(bits.data(), words * sizeof(uint64_t)) != filterTrailer.checksum)
+        {
+            return false;
+        }
+
+        filter = BloomFilter(std::move(bits), filterTrailer.bitCount, filterTrailer.hashes);
+    }
+
+    size_t trailer = hasChecksums() ? sizeof(uint32_t) : 0;
+
+    for (const auto& entry : index)
+    {
+        if (entry.offset < sizeof(BlockHeader) || entry.offset > blocksEnd
+            || entry.size + trailer > blocksEnd - entry.offset)
+        {
+            return false;
+        }
+    }
+
+    file.adviseRandom();
+    return true;
+}
+
+bool BlockBookReader::verifyBlock(size_t block) const
+{
+    if (!hasChecksums())
+    {
+        return true;
+    }
+
+    const BlockIndexEntry& entry = index[block];
+    uint32_t stored;
+    memcpy(&stored, file.data() + entry.offset + entry.size, sizeof(stored));
+
+    return crc32c(file.data() + entry.offset, entry.size) == stored;
+}
+
+// Checks every block, threads pulling block numbers from a shared counter.
+// Returns the numbers of the corrupt blocks in ascending order.
+vector<size_t> BlockBookReader::verify(size_t threads) const
+{
+    atomic<size_t> next(0);
+    vector<vector<size_t>> bad(max<size_t>(threads, 1));
+    vector<thread> workers;
+
+    for (size_t t = 0; t < bad.size(); t++)
+    {
+        workers.emplace_back([this, &next, &bad, t]()
+        {
+            for (size_t block = next++; block < index.size(); block = next++)
+            {
+                if (!verifyBlock(block))
+                {
+                    bad[t].push_back(block);
+                }
+            }
+        });
+    }
+
+    vector<size_t> corrupt;
+
+    for (size_t t = 0; t < bad.size(); t++)
+    {
+        workers[t].join();
+        corrupt.insert(corrupt.end(), bad[t].begin(), bad[t].end());
+    }
+
+    sort(corrupt.begin(), corrupt.end());
+    return corrupt;
+}
+
+// Every read is bounded by the block's extent: a record count the block
+// cannot hold yields an empty block, and records that run past its end are
+// dropped. Version 2 blocks have no checksum to catch either first.
+PagedBlock BlockBookReader::decodeBlock(size_t block) const
+{
+    const BlockIndexEntry& entry = index[block];
+    const char* in = file.data() + entry.offset;
+    const char* end = in + entry.size;
+
+    if (packed())
+    {
+        // A packed record takes at least a key bit and a move count bit
+        if (entry.records > size_t(entry.size) * 4)
+        {
+            return PagedBlock();
+        }
+
+        PagedBlock decoded(entry.records);
+        unpackRecords(in, end, entry.firstKey, keysOnly(), decoded);
+        return decoded;
+    }
+
+    size_t fixed = sizeof(uint64_t) + (keysOnly() ? 0 : 32) + 1;
+
+    if (entry.records > entry.size / fixed)
+    {
+        return PagedBlock();
+    }
+
+    PagedBlock decoded(entry.records);
+
+    for (size_t r = 0; r < decoded.size(); r++)
+    {
+        PagedRecord& record = decoded[r];
+
+        if (static_cast<size_t>(end - in) < fixed)
+        {
+            decoded.resize(r);
+            break;
+        }
+
+        memcpy(&record.key, in, sizeof(record.key));
+        in += sizeof(record.key);
+
+        if (!keysOnly())
+        {
+            record.board.decode(in);
+            in += 32;
+        }
+
+        size_t count = static_cast<unsigned char>(*in++);
+
+        if (static_cast<size_t>(end - in) < count * MOVE_RECORD_SIZE)
+        {
+            decoded.resize(r);
+            break;
+        }
+
+        record.entries.reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int16_t move;
+            uint32_t moveCount;
+
+            memcpy(&move, in, sizeof(move));
+            memcpy(&moveCount, in + sizeof(move), sizeof(moveCount));
+            in += MOVE_RECORD_SIZE;
+
+            record.entries.push_back(MoveEntry(Move::decode(move), moveCount));
+        }
+    }
+
+    return decoded;
+}
+
+// LRU over decoded blocks. Misses decode outside the lock, so concurrent
+// probes into other blocks are not serialized behind a decode.
+shared_ptr<const PagedBlock> BlockBookReader::getBlock(size_t block)
+{
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = cached.find(block);
+
+        if (it != cached.end())
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // A corrupt block reads as empty, so its positions probe as misses
+    shared_ptr<const PagedBlock> decoded = make_shared<const PagedBlock>(verifyBlock(block) ? decodeBlock(block) : PagedBlock());
+
+    lock_guard<mutex> lock(cacheMutex);
+
+    // setCacheBlocks may resize the cache under the lock while this block decoded
+    if (cacheBlocks == 0)
+    {
+        return decoded;
+    }
+
+    auto it = cached.find(block);
+
+    if (it != cached.end())
+    {
+        return it->second->second;
+    }
+
+    lru.emplace_front(block, decoded);
+    cached[block] = lru.begin();
+
+    while (lru.size() > cacheBlocks)
+    {
+        cached.erase(lru.back().first);
+        lru.pop_back();
+    }
+
+    return decoded;
+}
+
+shared_ptr<const MoveList> BlockBookReader::find(uint64_t key, const Board& board)
+{
+    if (!filter.mayContain(key))
+    {
+        return nullptr;
+    }
+
+    auto it = lower_bound(index.begin(), index.end(), key,
+        [](const BlockIndexEntry& entry, uint64_t k) { return entry.lastKey < k; });
+
+    for (; it != index.end() && it->firstKey <= key; ++it)
+    {
+        shared_ptr<const PagedBlock> block = getBlock(it - index.begin());
+
+        auto record = lower_bound(block->begin(), block->end(), key,
+            [](const PagedRecord& r, uint64_t k) { return r.key < k; });
+
+        for (; record != block->end() && record->key == key; ++record)
+        {
+            if (keysOnly() || record->board == board)
+            {
+                // Aliases the block so eviction cannot free the entries in use
+                return shared_ptr<const MoveList>(block, &record->entries);
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+// Resident-only check: false when the key filter rules 'key' out or no
+// block's key range covers it. Books before version 5 have only the ranges.
+bool BlockBookReader::mayContain(uint64_t key) const
+{
+    if (!filter.mayContain(key))
+    {
+        return false;
+    }
+
+    auto it = lower_bound(index.begin(), index.end(), key,
+        [](const BlockIndexEntry& entry, uint64_t k) { return entry.lastKey < k; });
+
+    return it != index.end() && it->firstKey <= key;
+}
+
+void BlockBookReader::setCacheBlocks(size_t _cacheBlocks)
+{
+    lock_guard<mutex> lock(cacheMutex);
+    cacheBlocks = _cacheBlocks;
+
+    while (lru.size() > cacheBlocks)
+    {
+        cached.erase(lru.back().first);
+        lru.pop_back();
+    }
+}
+
+size_t BlockBookReader::blockCount() const
+{
+    return index.size();
+}
+
+size_t BlockBookReader::records() const
+{
+    return recordCount;
+}
+
+size_t BlockBookReader::variations() const
+{
+    return header.variations;
+}
+
+size_t BlockBookReader::moves() const
+{
+    return header.moves;
+}
+
+bool BlockBookReader::keysOnly() const
+{
+    return (header.flags & BLOCK_KEYS_ONLY) != 0;
+}
+
+bool BlockBookReader::hasChecksums() const
+{
+    return header.version >= 3;
+}
+
+bool BlockBookReader::packed() const
+{
+    return (header.flags & BLOCK_PACKED) != 0;
+}
+
+uint32_t BlockBookReader::blockSize() const
+{
+    return header.blockSize;
+}
+
+uint32_t BlockBookReader::generation() const
+{
+    return header.generation;
+}
+
+void BlockBookReader::adviseSequential() const
+{
+    file.adviseSequential();
+}
+
+void BlockBookReader::prefault() const
+{
+    file.prefault();
+}
+
+bool BlockBookReader::lock() const
+{
+    return file.lock();
+}
+
+// Streaming k-way merge of key-sorted block books: one decoded block per
+// input is resident at a time. Records with the same key and board are
+// combined by summing the counts of equal moves and keeping the most played
+// 'variations'. Shards cut by key never overlap, so merging them only
+// interleaves records; books over overlapping positions combine lists that
+// were each trimmed already. Inputs must agree on variations, depth and
+// keys-only mode, and a corrupt block fails the merge. The output is packed
+// when asked for or when the first input is, and a zero block size keeps the
+// first input's.
+bool mergeBlockBooks(const vector<string>& paths, const string& path, const BookWriteOptions& options)
+{
+    struct Cursor
+    {
+        BlockBookReader reader;
+        size_t block = 0;
+        PagedBlock records;
+        size_t next = 0;
+    };
+
+    vector<unique_ptr<Cursor>> cursors;
+
+    for (const auto& input : paths)
+    {
+        cursors.push_back(make_unique<Cursor>());
+        BlockBookReader& reader = cursors.back()->reader;
+
+        if (!reader.open(input, 0) || reader.keysOnly() != cursors.front()->reader.keysOnly()
+            || reader.variations() != cursors.front()->reader.variations() || reader.moves() != cursors.front()->reader.moves())
+        {
+            return false;
+        }
+
+        reader.adviseSequential();
+    }
+
+    if (cursors.empty())
+    {
+        return false;
+    }
+
+    bool keysOnly = cursors.front()->reader.keysOnly();
+    size_t variations = cursors.front()->reader.variations();
+    bool corrupt = false;
+
+    // Whether the cursor has a record left, decoding its next block if needed
+    auto fill = [&corrupt](Cursor& cursor)
+    {
+        while (cursor.next == cursor.records.size())
+        {
+            if (cursor.block == cursor.reader.blockCount())
+            {
+                return false;
+            }
+
+            if (!cursor.reader.verifyBlock(cursor.block))
+            {
+                corrupt = true;
+                return false;
+            }
+
+            cursor.records = cursor.reader.decodeBlock(cursor.block++);
+            cursor.next = 0;
+        }
+
+        return true;
+    };
+
+    typedef pair<uint64_t, size_t> HeapEntry;
+    priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry>> heap;
+
+    for (size_t i = 0; i < cursors.size(); i++)
+    {
+        if (fill(*cursors[i]))
+        {
+            heap.push({ cursors[i]->records.front().key, i });
+        }
+    }
+
+    BlockBookWriter writer;
+    uint16_t flags = (keysOnly ? BLOCK_KEYS_ONLY : 0) | (options.packed || cursors.front()->reader.packed() ? BLOCK_PACKED : 0);
+    uint32_t blockSize = options.blockSize != 0 ? options.blockSize : cursors.front()->reader.blockSize();
+
+    if (corrupt || !writer.open(path, variations, cursors.front()->reader.moves(), blockSize, flags, options.direct))
+    {
+        return false;
+    }
+
+    vector<PagedRecord> group;
+
+    while (!heap.empty())
+    {
+        uint64_t key = heap.top().first;
+        group.clear();
+
+        while (!heap.empty() && heap.top().first == key)
+        {
+            Cursor& cursor = *cursors[heap.top().second];
+            size_t input = heap.top().second;
+            heap.pop();
+
+            while (fill(cursor) && cursor.records[cursor.next].key == key)
+            {
+                group.push_back(std::move(cursor.records[cursor.next++]));
+            }
+
+            if (fill(cursor))
+            {
+                heap.push({ cursor.records[cursor.next].key, input });
+            }
+        }
+
+        if (corrupt)
+        {
+            writer.close(false);
+            return false;
+        }
+
+        // Colliding keys stay ordered by board bytes, as Book::write_blocked
+        // writes them; in keys-only books the key alone is the position
+        if (!keysOnly)
+        {
+            stable_sort(group.begin(), group.end(), [](const PagedRecord& a, const PagedRecord& b)
+            {
+                return memcmp(a.board.representation(), b.board.representation(), 64) < 0;
+            });
+        }
+
+        for (size_t first = 0; first < group.size();)
+        {
+            size_t last = first + 1;
+            while (last < group.size() && (keysOnly || group[last].board == group[first].board))
+            {
+                last++;
+            }
+
+            MoveList& merged = group[first].entries;
+
+            for (size_t i = first + 1; i < last; i++)
+            {
+                for (const auto& entry : group[i].entries)
+                {
+                    auto it = find_if(merged.begin(), merged.end(), [&entry](const MoveEntry& m) { return m.move.cmp(entry.move); });
+
+                    if (it == merged.end())
+                    {
+                        merged.push_back(entry);
+                        continue;
+                    }
+
+                    it->count += entry.count;
+                    it->error += entry.error;
+                }
+            }
+
+            if (last - first > 1)
+            {
+                stable_sort(merged.begin(), merged.end(), [](const MoveEntry& a, const MoveEntry& b) { return a.count > b.count; });
+                merged.resize(min(merged.size(), variations));
+            }
+
+            if (!writer.add(key, group[first].board, merged))
+            {
+                writer.close(false);
+                return false;
+            }
+
+            first = last;
+        }
+    }
+
+    return writer.close(options.sync);
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <list>
+#include "utils/bloom_filter.h"
+#include "utils/mapped_file.h"
+#include "utils/file_io.h"
+#include "utils/crc32c.h"
+#include "board.h"
+#include "book.h"
+
+using namespace std;
+
+// Block book layout: header, records sorted by zobristKey packed into blocks,
+// key filter, block index, footer. Only the filter and the index stay
+// resident; blocks are decoded on demand.
+//
+//   block  := records | crc32c u32 (of the records)
+//   record := key u64 | board 32B | n u8 | n * (move i16 | count u32)
+//
+// Version 2 files have no block checksums and are still readable. The
+// footer carries the CRC32C of the block index from version 3 on.
+//
+// With BLOCK_KEYS_ONLY the board is omitted and the 64-bit key alone
+// identifies the position (see the audit command for collision checks).
+//
+// With BLOCK_PACKED (version 4) the records of a block are one LSB-first
+// bit stream instead (see utils/bitstream.h):
+//
+//   block  := k u8 | packed records | crc32c u32
+//   record := rice_k(key - previous key) | [board] | gamma(n + 1)
+//             | n * move | gamma(first count + 1) | (n - 1) * gamma(zigzag(count delta) + 1)
+//   board  := occupancy u64 | 4 bits per occupied square
+//   move   := from 6 | to 6 | flagged 1 | [castle/promotion 2 | promotion piece 2]
+//
+// The first record's previous key is the block's firstKey from the index.
+//
+// From version 5 a Bloom filter over the record keys (utils/bloom_filter.h)
+// ends right where the index starts, so it is found from the footer:
+//
+//   filter := words u64[] | bit count u64 | hashes u32 | crc32c u32 (of the words)
+//
+// At BLOCK_FILTER_FP_RATE it costs about 1.2 bytes per record and lets
+// misses skip the block, which LayeredBook's layers rely on.
+
+constexpr char BLOCK_BOOK_MAGIC[4] = { 'P', 'N', 'B', 'K' };
+constexpr uint16_t BLOCK_BOOK_VERSION = 5;
+constexpr uint16_t BLOCK_BOOK_MIN_VERSION = 2;
+constexpr uint16_t BLOCK_KEYS_ONLY = 1 << 0;
+constexpr uint16_t BLOCK_PACKED = 1 << 1;
+constexpr double BLOCK_FILTER_FP_RATE = 0.01;
+
+// Packed blocks decode bit by bit, so they default to a smaller target to
+// keep the one block a probe decodes small
+constexpr uint32_t PACKED_BLOCK_SIZE = 4 << 10;
+
+struct BlockHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t blockSize;
+    uint32_t generation; // Learning compactions folded in (see BookLearner)
+    uint64_t variations;
+    uint64_t moves;
+};
+
+struct BlockIndexEntry
+{
+    uint64_t firstKey;
+    uint64_t lastKey;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t records;
+};
+
+struct BlockFooter
+{
+    uint64_t indexOffset;
+    uint64_t blockCount;
+    uint64_t recordCount;
+    char magic[4];
+    uint32_t indexChecksum;
+};
+
+struct BlockFilterTrailer
+{
+    uint64_t bitCount;
+    uint32_t hashes;
+    uint32_t checksum;
+};
+
+static_assert(sizeof(BlockHeader) == 32, "BlockHeader must be packed");
+static_assert(sizeof(BlockIndexEntry) == 32, "BlockIndexEntry must be packed");
+static_assert(sizeof(BlockFooter) == 32, "BlockFooter must be packed");
+static_assert(sizeof(BlockFilterTrailer) == 16, "BlockFilterTrailer must be packed");
+
+struct PagedRecord
+{
+    uint64_t key;
+    Board board;
+    MoveList entries;
+};
+
+typedef vector<PagedRecord> PagedBlock;
+
+bool isBlockBook(const char* data, size_t size);
+
+class BlockBookWriter
+{
+private:
+    OutputFile file;
+    vector<char> block;
+    vector<PagedRecord> pending; // Records of the open block when packing
+    size_t pendingBits;
+    vector<BlockIndexEntry> index;
+    vector<uint64_t> keys;
+    BlockIndexEntry current;
+    uint64_t offset;
+    uint64_t records;
+    uint32_t blockSize;
+    uint16_t flags;
+
+    bool flushBlock();
+    bool writeFilter();
+    bool addPacked(uint64_t key, const Board& board, const MoveList& entries);
+
+public:
+    BlockBookWriter();
+
+    bool open(const string& path, size_t variations, size_t moves, uint32_t blockSize, uint16_t flags, bool direct, uint32_t generation = 0);
+    bool add(uint64_t key, const Board& board, const MoveList& entries);
+    bool close(bool sync);
+};
+
+class BlockBookReader
+{
+private:
+    typedef list<pair<size_t, shared_ptr<const PagedBlock>>> LruList;
+
+    MappedFile file;
+    BlockHeader header;
+    vector<BlockIndexEntry> index;
+    BloomFilter filter;
+    uint64_t recordCount;
+
+    mutex cacheMutex;
+    LruList lru;
+    unordered_map<size_t, LruList::iterator> cached;
+    size_t cacheBlocks;
+
+public:
+    BlockBookReader();
+
+    bool open(const string& path, size_t cacheBlocks, HugePages hugePages = HUGE_PAGES_OFF);
+    bool verifyBlock(size_t block) const;
+    vector<size_t> verify(size_t threads) const;
+    PagedBlock decodeBlock(size_t block) const;
+    shared_ptr<const PagedBlock> getBlock(size_t block);
+    shared_ptr<const MoveList> find(uint64_t key, const Board& board);
+    bool mayContain(uint64_t key) const;
+    void setCacheBlocks(size_t cacheBlocks);
+    void adviseSequential() const;
+    void prefault() const;
+    bool lock() const;
+
+    size_t blockCount() const;
+    size_t records() const;
+    size_t variations() const;
+    size_t moves() const;
+    bool keysOnly() const;
+    bool packed() const;
+    bool hasChecksums() const;
+    uint32_t blockSize() const;
+    uint32_t generation() const;
+};
+
+bool mergeBlockBooks(const vector<string>& paths, const string& path, const BookWriteOptions& options);
@@ -1,7 +1,5 @@
 #include "board.h"
 
-constexpr auto NULL_FILE_RANK = 0x30;
-
 using namespace std;
 
 bool isLowerCase(char a)
@@ -9,170 +7,27 @@ bool isLowerCase(char a)
     return (a >= 'a') && (a <= 'z');
 }
 
-Square::Square(char _file, char _rank)
-{
-    file = _file;
-    rank = _rank;
-}
-
-size_t Square::toIndex() const 
-{
-    return (rank * 8) + file;
-}
-
-Square Square::decode(char s) 
-{
-    Square sqr(s & 0b111, s >> 3);
-    return sqr;
-}
-
-bool Square::isNull() const  
-{
-    return (file == NULL_FILE_RANK) && (rank == NULL_FILE_RANK);
-}
-
-Square Square::null()
-{
-    Square square(NULL_FILE_RANK, NULL_FILE_RANK);
-    return square;
-}
-
-Square Square::fromString(string s)
-{
-    Square sqr = Square::null();
-
-    switch (s.length()) 
-    {
-    case 2:
-    {
-        sqr.file = s[0] - 'a';
-        sqr.rank = 8 - (s[1] - '0');
-        break;
-    }
-    case 1:
-    {
-        if (('0' >= s[0]) && (s[0] <= '9')) 
-        {
-            sqr.rank = 8 - (s[1] - '0');
-            sqr.file = NULL_FILE_RANK;
-        }
-        else 
-        {
-            sqr.file = s[0] - 'a';
-            sqr.rank = NULL_FILE_RANK;
-        }
-        break;
-    }
-    }
-
-    return sqr;
-}
-
 string Square::toString() const
 {
     return string() + (char)(file + 'a') + (char)((8 - rank) + '0');
 }
 
-bool Move::isCastle() const 
+string Move::toUci() const
 {
-    Move e1g1("e1g1");
-    Move e1c1("e1c1");
-    Move e8g8("e8g8");
-    Move e8c8("e8c8");
-
-    return this->cmp(e1g1)
-        || this->cmp(e1c1)
-        || this->cmp(e8g8)
-        || this->cmp(e8c8);
-}
+    static constexpr char PROMOTION_LETTERS[] = { 'n', 'b', 'r', 'q' };
 
-Move::Move(const string& uci_mov)
-{
-    if (uci_mov.length() != 4)
-    {
-        throw invalid_argument("Invalid UCI move format. Expected format:: 'e2e4'.");
-    }
+    char from = fromSquare();
+    char to = toSquare();
 
-    string from_square = uci_mov.substr(0, 2);
-    string to_square = uci_mov.substr(2, 2);
+    string uci = string() + (char)((from & 0b111) + 'a') + (char)('8' - (from >> 3))
+        + (char)((to & 0b111) + 'a') + (char)('8' - (to >> 3));
 
-    char file1 = from_square[0] - 'a';
-    char file2 = to_square[0] - 'a';
-
-    if (!isLowerCase(from_square[0]) || !isLowerCase(to_square[0]))
+    if (isPromotion())
     {
-        throw invalid_argument("Invalid UCI move. File must be lowercase characters. Example:: 'e2e4'.");
+        uci += PROMOTION_LETTERS[promotionPiece()];
     }
 
-    char rank1 = 8 - (from_square[1] - '0');
-    char rank2 = 8 - (to_square[1] - '0');
-
-    from = (rank1 << 3) + file1;
-    to = (rank2 << 3) + file2;
-}
-
-void Move::fromSquares(Square to, Square from) 
-{
-    from = from;
-    to = to;
-}
-
-int16_t Move::encode() const
-{
-    return (from << 8) | to;
-}
-
-Move Move::decode(int16_t enc)
-{
-    Move move = Move::null();
-
-    move.from = enc >> 8;
-    move.to = enc & 0xFF;
-
-    return move;
-}
-
-char Move::fromSquare() const
-{
-    return from;
-}
-
-char Move::toSquare() const
-{
-    return to;
-}
-
-bool Move::isNull() const
-{
-    return to == from;
-}
-
-Move::Move() 
-{
-    from = NULL_FILE_RANK;
-    to = NULL_FILE_RANK;
-}
-
-Move Move::null() 
-{
-    Move null("a1a1");
-    return null;
-}
-
-string Move::toUci() const
-{
-    char from_file = (from & 0b111) + 'a';
-    char from_rank = '8' - (from >> 3);
-
-    char to_file = (to & 0b111) + 'a';
-    char to_rank = '8' - (to >> 3);
-
-    return string() + from_file + from_rank + to_file + to_rank;
-}
-
-bool Move::cmp(const Move& other) const
-{
-    return (from == other.from) && (to == other.to);
+    return uci;
 }
 
 Board::Board()
@@ -200,16 +55,20 @@ Board::Board()
 char* Board::encode() const
 {
     static char enc[32] = { 0 };
+    encode(enc);
 
+    return enc;
+}
+
+void Board::encode(char* enc) const
+{
     for (char i = 0; i < 32; i++)
     {
         enc[i] = (board[i * 2] << 4) | board[(i * 2) + 1];
     }
-
-    return enc;
 }
 
-void Board::decode(char* enc)
+void Board::decode(const char* enc)
 {
     for (char i = 0; i < 32; i++)
     {
@@ -223,22 +82,89 @@ const char* Board::representation() const
     return reinterpret_cast<const char*>(board);
 }
 
-void Board::makeMove(const Move& move)
+bool Board::whiteToMove() const
 {
-    if (move.isCastle()) 
+    return sideToMove;
+}
+
+void Board::setWhiteToMove(bool white)
+{
+    sideToMove = white;
+}
+
+// Piece placement and side to move; castling, en passant and clocks are not
+// tracked by Board and are written as "- - 0 1".
+string Board::toFen() const
+{
+    string fen;
+
+    for (int rank = 0; rank < 8; rank++)
     {
-        Square toRook = Square::decode(move.toSquare());
-        toRook.file -= 1;
+        int empty = 0;
+
+        for (int file = 0; file < 8; file++)
+        {
+            char piece = board[(rank * 8) + file];
+
+            if (piece == NN)
+            {
+                empty++;
+                continue;
+            }
+
+            if (empty > 0)
+            {
+                fen += (char)('0' + empty);
+                empty = 0;
+            }
+
+            fen += pieceToChar(decodePiece(piece));
+        }
 
-        Square fromRook = Square::decode(move.toSquare());
-        fromRook.file += 1;
+        if (empty > 0)
+        {
+            fen += (char)('0' + empty);
+        }
+
+        if (rank < 7)
+        {
+            fen += '/';
+        }
+    }
+
+    return fen + (sideToMove ? " w" : " b") + " - - 0 1";
+}
+
+// Castling is recognised by its flag or, for moves that came in as UCI, by
+// the king stepping two files. A pawn moving diagonally onto an empty square
+// captures en passant.
+void Board::makeMove(const Move& move)
+{
+    static constexpr char PROMOTED[2][4] = { { BN, BB, BR, BQ }, { WN, WB, WR, WQ } };
+
+    Square from = Square::decode(move.fromSquare());
+    Square to = Square::decode(move.toSquare());
+    char piece = board[from.toIndex()];
+
+    bool king = piece == WK || piece == BK;
+    bool pawn = piece == WP || piece == BP;
+
+    if (move.isCastle() || (king && (to.file - from.file == 2 || from.file - to.file == 2)))
+    {
+        bool kingside = to.file > from.file;
+        Square fromRook(kingside ? 7 : 0, to.rank);
+        Square toRook(kingside ? 5 : 3, to.rank);
 
         board[toRook.toIndex()] = board[fromRook.toIndex()];
         board[fromRook.toIndex()] = NN;
     }
+    else if (pawn && from.file != to.file && board[to.toIndex()] == NN)
+    {
+        board[Square(to.file, from.rank).toIndex()] = NN;
+    }
 
-    board[move.toSquare()] = board[move.fromSquare()];
-    board[move.fromSquare()] = NN;
+    board[to.toIndex()] = move.isPromotion() ? PROMOTED[piece == WP][move.promotionPiece()] : piece;
+    board[from.toIndex()] = NN;
     sideToMove = !sideToMove;
 }
 
@@ -255,50 +181,106 @@ void Board::print() const
     }
 }
 
+// Throwing form for callers that treat a bad FEN as a usage error
 Board& Board::fromFen(const string& fen)
 {
     static Board board;
-    vector<string> parts = split(fen, " ");
 
-    string layout = parts[0];
-    vector<Piece> pieces(64, NN);
+    if (parseFen(fen, board) != PARSE_OK)
+    {
+        throw invalid_argument("Invalid fen.");
+    }
+
+    return board;
+}
+
+// Reads the placement and side-to-move fields; castling rights and the en
+// passant square are not tracked by Board. The placement must cover eight
+// ranks of eight squares with one king per side and no pawn on a back rank.
+// A missing side-to-move field means white. 'board' is only written on
+// success.
+ParseError Board::parseFen(string_view fen, Board& board)
+{
+    size_t space = fen.find(' ');
+    string_view layout = fen.substr(0, space);
+    string_view side = space == string_view::npos ? string_view() : fen.substr(space + 1);
+
+    while (!side.empty() && side[0] == ' ')
+    {
+        side.remove_prefix(1);
+    }
+
+    char pieces[64];
+    int file = 0, rank = 0;
+    int kings[2] = { 0, 0 };
 
-    int index = 0;
     for (char c : layout)
     {
-        if (isdigit(c))
+        if (c == '/')
         {
-            index += c - '0';
+            if (file != 8 || ++rank > 7)
+            {
+                return PARSE_ILLEGAL_FEN;
+            }
+
+            file = 0;
+            continue;
         }
-        else
+
+        if (c >= '1' && c <= '8')
         {
-            switch (c)
+            if (file + (c - '0') > 8)
             {
-            case 'p': pieces[index] = BP; break;
-            case 'r': pieces[index] = BR; break;
-            case 'n': pieces[index] = BN; break;
-            case 'b': pieces[index] = BB; break;
-            case 'q': pieces[index] = BQ; break;
-            case 'k': pieces[index] = BK; break;
-            case 'P': pieces[index] = WP; break;
-            case 'R': pieces[index] = WR; break;
-            case 'N': pieces[index] = WN; break;
-            case 'B': pieces[index] = WB; break;
-            case 'Q': pieces[index] = WQ; break;
-            case 'K': pieces[index] = WK; break;
-            case '/': continue;
-            default: throw invalid_argument("Invalid fen.");
+                return PARSE_ILLEGAL_FEN;
             }
-            index++;
+
+            for (int run = c - '0'; run > 0; run--)
+            {
+                pieces[(rank * 8) + file++] = NN;
+            }
+
+            continue;
         }
+
+        Piece piece;
+        switch (c)
+        {
+        case 'p': piece = BP; break;
+        case 'r': piece = BR; break;
+        case 'n': piece = BN; break;
+        case 'b': piece = BB; break;
+        case 'q': piece = BQ; break;
+        case 'k': piece = BK; kings[1]++; break;
+        case 'P': piece = WP; break;
+        case 'R': piece = WR; break;
+        case 'N': piece = WN; break;
+        case 'B': piece = WB; break;
+        case 'Q': piece = WQ; break;
+        case 'K': piece = WK; kings[0]++; break;
+        default: return PARSE_ILLEGAL_FEN;
+        }
+
+        if (file == 8 || ((piece == WP || piece == BP) && (rank == 0 || rank == 7)))
+        {
+            return PARSE_ILLEGAL_FEN;
+        }
+
+        pieces[(rank * 8) + file++] = piece;
     }
 
-    for (int i = 0; i < 64; i++) {
-        board.board[i] = pieces[i];
+    if (rank != 7 || file != 8 || kings[0] != 1 || kings[1] != 1)
+    {
+        return PARSE_ILLEGAL_FEN;
     }
 
-    board.sideToMove = parts[1] == "w" ? true : false;
-    return board;
+    if (!side.empty() && side[0] != 'w' && side[0] != 'b')
+    {
+        return PARSE_ILLEGAL_FEN;
+    }
+
+    memcpy(board.board, pieces, sizeof(pieces));
+    board.sideToMove = side.empty() || side[0] == 'w';
+    return PARSE_OK;
 }
 
 bool Board::operator==(const Board& other) const 
@@ -314,302 +296,320 @@ size_t Board::indexFromFr(char file, char rank) const
     return (rank << 3) + file;
 }
 
-string Board::sanToUci(string& san) const
+static constexpr bool isFileChar(char c) { return c >= 'a' && c <= 'h'; }
+static constexpr bool isRankChar(char c) { return c >= '1' && c <= '8'; }
+
+static constexpr int KNIGHT_STEPS[8][2] = { {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2} };
+
+// Diagonal steps first, then orthogonal ones
+static constexpr int KING_STEPS[8][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1}, {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+const char* parseErrorName(ParseError error)
 {
-    if (san.back() == '#' || san.back() == '+')
+    switch (error)
     {
-        san = san.substr(0, san.length() - 1);
+    case PARSE_OK: return "ok";
+    case PARSE_MALFORMED: return "malformed move";
+    case PARSE_UNKNOWN_PIECE: return "unknown piece";
+    case PARSE_NO_CANDIDATE: return "no candidate";
+    case PARSE_AMBIGUOUS: return "ambiguous move";
+    case PARSE_ILLEGAL_FEN: return "illegal FEN";
+    default: return "unknown error";
     }
+}
 
-    if (san == "O-O") 
-    {
-        return sideToMove ? "e1g1" : "e8g8";
-    }
-    else if (san == "O-O-O") 
+// Resolves SAN against this position without building any strings: the
+// token is only ever narrowed as a string_view. 'move' is only written on
+// success.
+ParseError Board::sanToMove(string_view san, Move& move) const
+{
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
     {
-        return sideToMove ? "e1c1" : "e8c8";
+        san.remove_suffix(1);
     }
 
-    if (san.length() < 2) 
+    char homeRank = sideToMove ? 7 : 0;
+    char king = sideToMove ? WK : BK;
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
     {
-        throw invalid_argument("Invalid SAN move");
+        if (board[(homeRank << 3) + 4] != king)
+        {
+            return PARSE_NO_CANDIDATE;
+        }
+
+        move = Move::castle((homeRank << 3) + 4, (homeRank << 3) + (san.length() == 3 ? 6 : 2));
+        return PARSE_OK;
     }
 
-    string promotion = "";
-    string move = san;
+    bool promotes = false;
+    Promotion promotion = PROMOTE_QUEEN;
 
     size_t promotion_pos = san.find('=');
-    if (promotion_pos != string::npos)
+    if (promotion_pos != string_view::npos && promotion_pos + 1 < san.length())
     {
-        promotion = string(1, tolower(san[promotion_pos + 1]));
-        move = san.substr(0, promotion_pos);
+        switch (san[promotion_pos + 1])
+        {
+        case 'N': promotion = PROMOTE_KNIGHT; break;
+        case 'B': promotion = PROMOTE_BISHOP; break;
+        case 'R': promotion = PROMOTE_ROOK; break;
+        case 'Q': promotion = PROMOTE_QUEEN; break;
+        default: return PARSE_UNKNOWN_PIECE;
+        }
+
+        promotes = true;
+        san = san.substr(0, promotion_pos);
     }
 
-    if (move.length() == 2 && islower(move[0]) && isdigit(move[1]))
+    if (san.length() < 2 || !isFileChar(san[san.length() - 2]) || !isRankChar(san.back()))
     {
-        char file = move[0] - 'a';
-        char rank = 8 - (move[1] - '0');
-        char o_rank;
-
-        if ((board[indexFromFr(file, (o_rank = rank - 1))] == BP && !sideToMove)
-            || (board[indexFromFr(file, (o_rank = rank + 1))] == WP && sideToMove)
-            || (rank == 4 && board[indexFromFr(file, (o_rank = rank + 2))] == WP)
-            || (rank == 3 && board[indexFromFr(file, (o_rank = rank - 2))] == BP))
-        {
-            char fileLetter = file + 'a';
-            char rankNumber = (8 - o_rank) + '0';
-
-            return string() + fileLetter + rankNumber + san;
-        }
-        else 
-        {
-            throw invalid_argument("Invalid move.");
-        }
+        return PARSE_MALFORMED;
     }
 
-    Square ambiguity = Square::null();
-    Square goal = Square::null();
-    size_t xI = 0;
-    char piece;
+    Square goal = Square::fromString(san.substr(san.length() - 2));
+    san.remove_suffix(2);
 
-    if ((xI = san.find('x')) != string::npos) 
+    char piece = 'P';
+    if (!san.empty() && !isFileChar(san[0]))
     {
-        bool isPawn = islower(san[0]);
+        piece = san[0];
+        san.remove_prefix(1);
+    }
 
-        if (isPawn) 
-        {
-            ambiguity = Square::fromString(san.substr(0, xI));
-            goal = Square::fromString(san.substr(xI + 1));
-            piece = 'P';
-        }
-        else 
-        {
-            ambiguity = Square::fromString(san.substr(1, xI-1));
-            goal = Square::fromString(san.substr(xI + 1));
-            piece = san[0];
-        }
+    if (!san.empty() && san.back() == 'x')
+    {
+        san.remove_suffix(1);
     }
-    else 
+
+    // What is left is the disambiguation: a file, a rank or both
+    Square ambiguity = Square::fromString(san);
+    Square origin = Square::null();
+
+    ParseError error = findPiece(piece, goal, ambiguity, origin);
+    if (error != PARSE_OK)
     {
-        if (islower(san[0])) 
-        {
-            ambiguity = Square::fromString(san.substr(0, 1));
-            piece = 'P';
-        }
-        else 
-        {
-            ambiguity = Square::fromString(san.substr(1, san.length() - 3));
-            piece = san[0];
-        }
-        
-        goal = Square::fromString(san.substr(san.length() - 2, 2));
+        return error;
     }
 
-    return findPiece(piece, goal, ambiguity).toString() + goal.toString();
+    move = promotes ? Move::promotion(origin.toIndex(), goal.toIndex(), promotion) : Move(origin.toIndex(), goal.toIndex());
+    return PARSE_OK;
 }
 
-Square Board::findPiece(char piece, Square goal, Square ambgClarifier) const
+// Empty when the SAN does not resolve in this position
+string Board::sanToUci(string& san) const
 {
-    vector<Square> candidates;
+    Move move;
+    return sanToMove(san, move) == PARSE_OK ? move.toUci() : string();
+}
 
-    switch (piece)
+// Finds the origin square of a piece of the side to move that reaches
+// 'goal', honouring whatever file/rank disambiguation the SAN gave. Sliding
+// pieces stop at the first occupied square. SAN only disambiguates between
+// legal moves, so when several pieces qualify the ones pinned to their king
+// are dropped before the move is called ambiguous.
+ParseError Board::findPiece(char piece, Square goal, Square ambgClarifier, Square& origin) const
+{
+    char target = charToPiece(piece, sideToMove);
+    char occupant = board[goal.toIndex()];
+
+    if (occupant != NN && (occupant < BP) == sideToMove)
     {
-    case 'N': case 'n':
+        return PARSE_NO_CANDIDATE;
+    }
+
+    char candidates[10];
+    size_t found = 0;
+
+    auto consider = [&](Square sq)
     {
-        int knightOffsets[8][2] =
+        if ((ambgClarifier.file != NULL_FILE_RANK && sq.file != ambgClarifier.file)
+            || (ambgClarifier.rank != NULL_FILE_RANK && sq.rank != ambgClarifier.rank))
+        {
+            return;
+        }
+
+        if (found < size(candidates))
         {
-            {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
-            {1, 2}, {1, -2}, {-1, 2}, {-1, -2},
-        };
+            candidates[found++] = sq.toIndex();
+        }
+    };
 
-        for (int i = 0; i < 8; i++)
+    auto leaps = [&](const int (*offsets)[2], size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
         {
-            Square newSQ(goal.file + knightOffsets[i][0], goal.rank + knightOffsets[i][1]);
+            Square sq(goal.file + offsets[i][0], goal.rank + offsets[i][1]);
 
-            if (ambgClarifier.file != NULL_FILE_RANK && newSQ.file != ambgClarifier.file)
+            if (sq.onBoard() && board[sq.toIndex()] == target)
             {
-                continue;
+                consider(sq);
             }
+        }
+    };
 
-            if (ambgClarifier.rank != NULL_FILE_RANK && newSQ.rank != ambgClarifier.rank)
+    auto slides = [&](const int (*offsets)[2], size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            Square sq(goal.file + offsets[i][0], goal.rank + offsets[i][1]);
+
+            while (sq.onBoard() && board[sq.toIndex()] == NN)
             {
-                continue;
+                sq.file += offsets[i][0];
+                sq.rank += offsets[i][1];
             }
 
-            if (board[newSQ.toIndex()] == charToPiece(piece, sideToMove))
+            if (sq.onBoard() && board[sq.toIndex()] == target)
             {
-                candidates.push_back(newSQ);
+                consider(sq);
             }
         }
-        break;
-    }
+    };
 
-    case 'B': case 'b':
+    switch (piece)
     {
-        int bishopOffsets[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    case 'N': case 'n': leaps(KNIGHT_STEPS, 8); break;
+    case 'K': case 'k': leaps(KING_STEPS, 8); break;
+    case 'B': case 'b': slides(KING_STEPS, 4); break;
+    case 'R': case 'r': slides(KING_STEPS + 4, 4); break;
+    case 'Q': case 'q': slides(KING_STEPS, 8); break;
 
-        for (int i = 0; i < 4; i++)
+    case 'P': case 'p':
+    {
+        int back = sideToMove ? 1 : -1;
+
+        if (ambgClarifier.file != NULL_FILE_RANK && ambgClarifier.file != goal.file)
         {
-            Square newSQ(goal.file + bishopOffsets[i][0], goal.rank + bishopOffsets[i][1]);
+            Square sq(ambgClarifier.file, goal.rank + back);
 
-            while (newSQ.file >= 0 && newSQ.file < 8 && newSQ.rank >= 0 && newSQ.rank < 8)
+            if (sq.onBoard() && board[sq.toIndex()] == target)
             {
-                if (ambgClarifier.file != NULL_FILE_RANK && newSQ.file != ambgClarifier.file)
-                {
-                    break;
-                }
-
-                if (ambgClarifier.rank != NULL_FILE_RANK && newSQ.rank != ambgClarifier.rank)
-                {
-                    break;
-                }
-
-                if (board[newSQ.toIndex()] == charToPiece(piece, sideToMove))
-                {
-                    candidates.push_back(newSQ);
-                    break;
-                }
-
-                newSQ.file += bishopOffsets[i][0];
-                newSQ.rank += bishopOffsets[i][1];
+                consider(sq);
             }
+
+            break;
         }
-        break;
-    }
 
-    case 'R': case 'r': // Rook
-    {
-        int rookOffsets[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
+        Square oneStep(goal.file, goal.rank + back);
+        Square twoSteps(goal.file, goal.rank + 2 * back);
 
-        for (int i = 0; i < 4; i++)
+        if (oneStep.onBoard() && board[oneStep.toIndex()] == target)
         {
-            Square newSQ(goal.file + rookOffsets[i][0], goal.rank + rookOffsets[i][1]);
-
-            while (newSQ.file >= 0 && newSQ.file < 8 && newSQ.rank >= 0 && newSQ.rank < 8)
-            {
-                if (ambgClarifier.file != NULL_FILE_RANK && newSQ.file != ambgClarifier.file)
-                {
-                    break;
-                }
-
-                if (ambgClarifier.rank != NULL_FILE_RANK && newSQ.rank != ambgClarifier.rank)
-                {
-                    break;
-                }
-
-                if (board[newSQ.toIndex()] == charToPiece(piece, sideToMove))
-                {
-                    candidates.push_back(newSQ);
-                    break;
-                }
-                  
-                newSQ.file += rookOffsets[i][0];
-                newSQ.rank += rookOffsets[i][1];
-            }
+            consider(oneStep);
+        }
+        else if (oneStep.onBoard() && board[oneStep.toIndex()] == NN && twoSteps.onBoard() && board[twoSteps.toIndex()] == target)
+        {
+            consider(twoSteps);
         }
+
         break;
     }
 
-    case 'Q': case 'q':
+    default:
+        return PARSE_UNKNOWN_PIECE;
+    }
+
+    if (found > 1)
     {
-        int queenOffsets[8][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+        size_t legal = 0;
 
-        for (int i = 0; i < 8; i++)
+        for (size_t i = 0; i < found; i++)
         {
-            Square newSQ(goal.file + queenOffsets[i][0], goal.rank + queenOffsets[i][1]);
-
-            while (newSQ.file >= 0 && newSQ.file < 8 && newSQ.rank >= 0 && newSQ.rank < 8)
+            if (!exposesKing(Square::decode(candidates[i]), goal))
             {
-                if (ambgClarifier.file != NULL_FILE_RANK && newSQ.file != ambgClarifier.file)
-                {
-                    break;
-                }
-
-                if (ambgClarifier.rank != NULL_FILE_RANK && newSQ.rank != ambgClarifier.rank)
-                {
-                    break;
-                }
-
-                if (board[newSQ.toIndex()] == charToPiece(piece, sideToMove))
-                {
-                    candidates.push_back(newSQ);
-                    break;
-                }
-
-                newSQ.file += queenOffsets[i][0];
-                newSQ.rank += queenOffsets[i][1];
+                candidates[legal++] = candidates[i];
             }
         }
-        break;
+
+        found = legal;
     }
 
-    case 'K': case 'k':
+    if (found == 0)
     {
-        int kingOffsets[8][2] =
-        {
-            {1, 1}, {1, -1}, {-1, 1}, {-1, -1},
-            {1, 0}, {-1, 0}, {0, 1}, {0, -1},
-        };
+        return PARSE_NO_CANDIDATE;
+    }
 
-        for (int i = 0; i < 8; i++)
-        {
-            Square newSQ(goal.file + kingOffsets[i][0], goal.rank + kingOffsets[i][1]);
+    if (found > 1)
+    {
+        return PARSE_AMBIGUOUS;
+    }
 
-            if (ambgClarifier.file != NULL_FILE_RANK && newSQ.file != ambgClarifier.file)
-            {
-                continue;
-            }
+    origin = Square::decode(candidates[0]);
+    return PARSE_OK;
+}
 
-            if (ambgClarifier.rank != NULL_FILE_RANK && newSQ.rank != ambgClarifier.rank)
-            {
-                continue;
-            }
+// Whether a piece of the given colour attacks 'sq' in this position
+bool Board::attacked(Square sq, bool byWhite) const
+{
+    char pawn = byWhite ? WP : BP;
+    char knight = byWhite ? WN : BN;
+    char bishop = byWhite ? WB : BB;
+    char rook = byWhite ? WR : BR;
+    char queen = byWhite ? WQ : BQ;
+    char king = byWhite ? WK : BK;
+
+    // White pawns attack towards rank 0, so they sit one rank index higher
+    for (int side : { -1, 1 })
+    {
+        Square from(sq.file + side, sq.rank + (byWhite ? 1 : -1));
 
-            if (board[newSQ.toIndex()] == charToPiece(piece, sideToMove))
-            {
-                candidates.push_back(newSQ);
-            }
+        if (from.onBoard() && board[from.toIndex()] == pawn)
+        {
+            return true;
         }
-        break;
     }
 
-    case 'P': case 'p':
+    for (size_t i = 0; i < 8; i++)
     {
-        if (ambgClarifier.file != NULL_FILE_RANK) 
+        Square leap(sq.file + KNIGHT_STEPS[i][0], sq.rank + KNIGHT_STEPS[i][1]);
+        if (leap.onBoard() && board[leap.toIndex()] == knight)
         {
-            int direction = sideToMove ? 1 : -1;
-            Square oneStep(ambgClarifier.file, goal.rank + direction);
+            return true;
+        }
 
-            if (board[oneStep.toIndex()] == charToPiece(piece, sideToMove))
-            {
-                candidates.push_back(oneStep);
-            }
+        Square step(sq.file + KING_STEPS[i][0], sq.rank + KING_STEPS[i][1]);
+        if (step.onBoard() && board[step.toIndex()] == king)
+        {
+            return true;
         }
-        else 
+
+        Square ray = step;
+        while (ray.onBoard() && board[ray.toIndex()] == NN)
         {
-            for (int i = 1; i < 3; i++) 
-            {
-                int direction = sideToMove ? -i : i;
-                Square step(ambgClarifier.file, goal.rank + direction);
+            ray.file += KING_STEPS[i][0];
+            ray.rank += KING_STEPS[i][1];
+        }
+
+        if (ray.onBoard())
+        {
+            char piece = board[ray.toIndex()];
 
-                if (board[step.toIndex()] == charToPiece(piece, sideToMove))
-                {
-                    candidates.push_back(step);
-                }
+            if (piece == queen || piece == (i < 4 ? bishop : rook))
+            {
+                return true;
             }
         }
-
-        break;
     }
 
-    default:
-        throw invalid_argument("Unknown piece type");
-    }
+    return false;
+}
+
+// Plays from -> to on a copy and checks whether the mover's king is left
+// attacked
+bool Board::exposesKing(Square from, Square to) const
+{
+    Board after = *this;
+    after.makeMove(Move(from.toIndex(), to.toIndex()));
+
+    char king = sideToMove ? WK : BK;
 
-    if (candidates.size() == 0) 
+    for (size_t i = 0; i < 64; i++)
     {
-        throw invalid_argument("invalid move.");
+        if (after.board[i] == king)
+        {
+            return after.attacked(Square::decode(static_cast<char>(i)), !sideToMove);
+        }
     }
 
-    return candidates[0];
+    return false;
 }
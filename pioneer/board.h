@@ -5,6 +5,8 @@
 #include <cstring>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <cstdint>
 #include "utils\split.h"
 #include "piece.h"
@@ -13,61 +15,192 @@ using namespace std;
 
 bool isLowerCase(char a);
 
+constexpr char NULL_FILE_RANK = 0x30;
+
+// File 0 is the a-file, rank 0 is the eighth rank, matching the board array.
+// A coordinate left at NULL_FILE_RANK means "unspecified", as in SAN
+// disambiguation.
 class Square
 {
 public:
-    Square(char _file, char _rank);
+    constexpr Square(char _file, char _rank) : file(_file), rank(_rank) {}
 
     char file;
     char rank;
 
-    size_t toIndex() const;
-    bool isNull() const;
-    static Square null();
-    static Square decode(char s);
-    static Square fromString(string s);
+    constexpr size_t toIndex() const { return (rank * 8) + file; }
+    constexpr bool isNull() const { return (file == NULL_FILE_RANK) && (rank == NULL_FILE_RANK); }
+    constexpr bool onBoard() const { return file >= 0 && file < 8 && rank >= 0 && rank < 8; }
+    static constexpr Square null() { return Square(NULL_FILE_RANK, NULL_FILE_RANK); }
+    static constexpr Square decode(char s) { return Square(s & 0b111, (s >> 3) & 0b111); }
+    static constexpr Square fromString(string_view s);
     string toString() const;
 };
 
+enum Promotion : uint8_t
+{
+    PROMOTE_KNIGHT,
+    PROMOTE_BISHOP,
+    PROMOTE_ROOK,
+    PROMOTE_QUEEN
+};
+
+// Why a SAN move or a FEN could not be read. Ingest counts these per
+// category and skips the game instead of throwing.
+enum ParseError : uint8_t
+{
+    PARSE_OK,
+    PARSE_MALFORMED,
+    PARSE_UNKNOWN_PIECE,
+    PARSE_NO_CANDIDATE,
+    PARSE_AMBIGUOUS,
+    PARSE_ILLEGAL_FEN,
+    PARSE_ERROR_COUNT
+};
+
+const char* parseErrorName(ParseError error);
+
+// A move in the 16-bit encoding stored in book files: the origin square in
+// the high byte, the target in the low byte. Squares take 6 bits, the two
+// spare bits of each byte carry the promotion piece (high byte) and the
+// promotion/castle flags (low byte). Moves written before the flags existed
+// decode unchanged.
 class Move
 {
 private:
-    char from;
-    char to;
+    uint16_t bits;
+
+    static constexpr uint16_t SQUARE_MASK = 0x3F;
+    static constexpr uint16_t PROMOTION_FLAG = 1 << 6;
+    static constexpr uint16_t CASTLE_FLAG = 1 << 7;
+    static constexpr unsigned PROMOTION_SHIFT = 14;
+
+    constexpr explicit Move(uint16_t _bits) : bits(_bits) {}
 
 public:
-    Move(const string& uci_mov);
-    Move();
-
-    int16_t encode() const;
-    static Move decode(int16_t enc);
-    char fromSquare() const;
-    char toSquare() const;
-    bool isNull() const;
-    bool isCastle() const;
+    constexpr Move() : bits(null().bits) {}
+    constexpr Move(string_view uci_mov);
+    constexpr Move(char from, char to) : bits(static_cast<uint16_t>(((from & SQUARE_MASK) << 8) | (to & SQUARE_MASK))) {}
+
+    static constexpr Move promotion(char from, char to, Promotion piece)
+    {
+        return Move(static_cast<uint16_t>(Move(from, to).bits | PROMOTION_FLAG | (piece << PROMOTION_SHIFT)));
+    }
+
+    static constexpr Move castle(char from, char to)
+    {
+        return Move(static_cast<uint16_t>(Move(from, to).bits | CASTLE_FLAG));
+    }
+
+    static constexpr Move null() { return Move(static_cast<uint16_t>((56 << 8) | 56)); } // a1a1
+
+    // "e2e4", "e7e8q"; 'move' is only written on success
+    static constexpr ParseError parseUci(string_view uci, Move& move);
+
+    constexpr int16_t encode() const { return static_cast<int16_t>(bits); }
+    static constexpr Move decode(int16_t enc) { return Move(static_cast<uint16_t>(enc)); }
+    constexpr char fromSquare() const { return static_cast<char>((bits >> 8) & SQUARE_MASK); }
+    constexpr char toSquare() const { return static_cast<char>(bits & SQUARE_MASK); }
+    constexpr bool isNull() const { return fromSquare() == toSquare(); }
+    constexpr bool isCastle() const { return (bits & CASTLE_FLAG) != 0; }
+    constexpr bool isPromotion() const { return (bits & PROMOTION_FLAG) != 0; }
+    constexpr Promotion promotionPiece() const { return static_cast<Promotion>(bits >> PROMOTION_SHIFT); }
     string toUci() const;
-    static Move null();
-    static void fromSquares(Square to, Square from);
-    bool cmp(const Move& other) const;
 
+    // The castle flag is derived from the position and only set by SAN
+    // resolution, so it does not take part in identity.
+    constexpr bool cmp(const Move& other) const { return ((bits ^ other.bits) & ~CASTLE_FLAG) == 0; }
 };
 
+static_assert(sizeof(Move) == sizeof(int16_t), "Move must stay 16 bits");
+static_assert(is_trivially_copyable_v<Move>, "Move must be trivially copyable");
+
+// "e4", "e", "4"; anything else yields Square::null()
+constexpr Square Square::fromString(string_view s)
+{
+    Square sqr = Square::null();
+
+    for (char c : s)
+    {
+        if (c >= 'a' && c <= 'h')
+        {
+            sqr.file = c - 'a';
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            sqr.rank = 8 - (c - '0');
+        }
+    }
+
+    return sqr;
+}
+
+constexpr ParseError Move::parseUci(string_view uci, Move& move)
+{
+    if (uci.length() != 4 && uci.length() != 5)
+    {
+        return PARSE_MALFORMED;
+    }
+
+    if (uci[0] < 'a' || uci[0] > 'h' || uci[2] < 'a' || uci[2] > 'h'
+        || uci[1] < '1' || uci[1] > '8' || uci[3] < '1' || uci[3] > '8')
+    {
+        return PARSE_MALFORMED;
+    }
+
+    char from = ((8 - (uci[1] - '0')) << 3) + (uci[0] - 'a');
+    char to = ((8 - (uci[3] - '0')) << 3) + (uci[2] - 'a');
+
+    if (uci.length() == 4)
+    {
+        move = Move(from, to);
+        return PARSE_OK;
+    }
+
+    switch (uci[4])
+    {
+    case 'n': move = promotion(from, to, PROMOTE_KNIGHT); break;
+    case 'b': move = promotion(from, to, PROMOTE_BISHOP); break;
+    case 'r': move = promotion(from, to, PROMOTE_ROOK); break;
+    case 'q': move = promotion(from, to, PROMOTE_QUEEN); break;
+    default: return PARSE_UNKNOWN_PIECE;
+    }
+
+    return PARSE_OK;
+}
+
+constexpr Move::Move(string_view uci_mov) : bits(0)
+{
+    if (parseUci(uci_mov, *this) != PARSE_OK)
+    {
+        throw invalid_argument("Invalid UCI move. Expected format:: 'e2e4' or 'e7e8q'.");
+    }
+}
+
 class Board
 {
 private:
     char board[64];
     bool sideToMove;
 
-    Square findPiece(char piece, Square goal, Square ambgClarifier) const;
+    ParseError findPiece(char piece, Square goal, Square ambgClarifier, Square& origin) const;
+    bool attacked(Square sq, bool byWhite) const;
+    bool exposesKing(Square from, Square to) const;
 
 public:
     Board();
     char* encode() const;
-    void decode(char* enc);
+    void encode(char* enc) const;
+    void decode(const char* enc);
     void makeMove(const Move& move);
     static Board& fromFen(const string& fen);
+    static ParseError parseFen(string_view fen, Board& board);
     const char* representation() const;
+    bool whiteToMove() const;
+    void setWhiteToMove(bool white);
+    string toFen() const;
     bool operator==(const Board& other) const;
+    ParseError sanToMove(string_view san, Move& move) const;
     string sanToUci(string& uci) const;
     size_t indexFromFr(char file, char rank) const;
     void print() const;
@@ -1,18 +1,45 @@
 #include <algorithm>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include "block_book.h"
 #include "book.h"
 
 using namespace std;
 
-MoveEntry::MoveEntry(Move _move, unsigned char _count)
-    : move(_move), count(_count) {}
+MoveEntry::MoveEntry(Move _move, uint32_t _count)
+    : count(_count), error(0), move(_move) {}
 
 MoveEntry::MoveEntry() 
 {
     move = Move::null();
     count = 0;
+    error = 0;
 }
 
-Book::Book(size_t variations, size_t moves) : variations(variations), moves(moves), pgns(0) {}
+Book::Book(size_t variations, size_t moves) : book(nullptr), keyed(nullptr), variations(variations), moves(moves), pgns(0), bounded(false), locked(false), shard(0), shards(1)
+{
+    resetTable();
+}
+
+// Everything the table owns is arena memory; the arena unmaps it in bulk.
+Book::~Book() {}
+
+// Drops the current table without walking it: nodes, buckets and move lists
+// are all arena allocations and MoveEntry is trivially destructible, so
+// unmapping the slabs is all the cleanup there is.
+void Book::resetTable()
+{
+    arena.reset();
+    book = new (storage) BookMap(0, BoardHash(), equal_to<Board>(), BookMap::allocator_type(&arena));
+    keyed = new (keyedStorage) KeyMap(0, KeyHash(), equal_to<uint64_t>(), KeyMap::allocator_type(&arena));
+    filter = BloomFilter();
+}
+
+MoveList& Book::entriesFor(const Board& board)
+{
+    return book->try_emplace(board, MoveList::allocator_type(&arena)).first->second;
+}
 
 bool Book::cmpMoveEntry(const MoveEntry& a, const MoveEntry& b)
 {
@@ -21,7 +48,7 @@ bool Book::cmpMoveEntry(const MoveEntry& a, const MoveEntry& b)
 
 void Book::insertFromPgn(const Pgn& pgn)
 {
-    Board board;
+    Board board = pgn.startPosition();
     pgns += 1;
 
     for (size_t i = 0; i < min(pgn.moveCount(), moves); ++i)
@@ -32,41 +59,252 @@ void Book::insertFromPgn(const Pgn& pgn)
     }
 }
 
+// Same replay as insertFromPgn, but the moves are already resolved
+void Book::insertFromArchive(const ArchivedGame& game)
+{
+    Board board;
+    pgns += 1;
+
+    for (size_t i = 0; i < min<size_t>(game.plies, moves); ++i)
+    {
+        Move move = game.getMove(i);
+        insert(board, move);
+        board.makeMove(move);
+    }
+}
+
 void Book::resize_vector(size_t size)
 {
-    for (auto& pair : book)
+    auto trim = [size](MoveList& entries)
     {
-        vector<MoveEntry>& entries = pair.second;
         sort(entries.begin(), entries.end(), Book::cmpMoveEntry);
         if (entries.size() > size)
         {
             entries.resize(size);
         }
+    };
+
+    for (auto& pair : *book)
+    {
+        trim(pair.second);
+    }
+
+    for (auto& pair : *keyed)
+    {
+        trim(pair.second);
+    }
+}
+
+size_t Book::recordSize() const
+{
+    return 32 + variations * sizeof(int16_t);
+}
+
+// Records are fixed size, the move list is padded with null moves up to
+// 'variations' so the reader can step through the file without lengths.
+void Book::serializeRecord(const Board& board, const MoveList& entries, char* out) const
+{
+    static const int16_t NULL_MOVE = Move::null().encode();
+
+    board.encode(out); // 32 bytes for board
+    out += 32;
+
+    for (size_t i = 0; i < variations; i++)
+    {
+        int16_t move = i < entries.size() ? entries[i].move.encode() : NULL_MOVE;
+        memcpy(out, &move, sizeof(int16_t)); // Encoded move
+        out += sizeof(int16_t);
     }
 }
 
 void Book::write_book(ostream& stream)
 {
-    variations = min(variations, pgns);
+    variations = min<size_t>(min(variations, pgns), UINT8_MAX);
     stream.write(reinterpret_cast<const char*>(&variations), sizeof(variations));
     stream.write(reinterpret_cast<const char*>(&moves), sizeof(moves));
 
-    for (const auto& pair : book)
+    vector<char> record(recordSize());
+
+    for (const auto& pair : *book)
     {
-        char* board = pair.first.encode();
-        stream.write(board, 32); // 32 bytes for board
+        serializeRecord(pair.first, pair.second, record.data());
+        stream.write(record.data(), record.size());
+    }
+}
 
-        for (const auto& moveEntry : pair.second)
+// Serializes the table in rounds: each worker fills its own buffer from a
+// contiguous slice of the map's iteration order, then the buffers are written
+// in slice order. The bytes are identical to write_book(ostream&) for any
+// thread count.
+bool Book::write_book(const string& path, const BookWriteOptions& options)
+{
+    if (options.format != LEGACY_FORMAT)
+    {
+        return write_blocked(path, options);
+    }
+
+    // Positions loaded from a compact book have no boards to write
+    if (!keyed->empty())
+    {
+        return false;
+    }
+
+    OutputFile file;
+    if (!file.open(path, options.direct))
+    {
+        return false;
+    }
+
+    if (!options.keepVariations)
+    {
+        variations = min(variations, pgns);
+    }
+
+    // No position has more legal moves, and read_book rejects more
+    variations = min<size_t>(variations, UINT8_MAX);
+
+    char header[sizeof(variations) + sizeof(moves)];
+    memcpy(header, &variations, sizeof(variations));
+    memcpy(header + sizeof(variations), &moves, sizeof(moves));
+
+    if (!file.write(header, sizeof(header)))
+    {
+        return false;
+    }
+
+    vector<const BookMap::value_type*> records;
+    records.reserve(book->size());
+
+    for (const auto& pair : *book)
+    {
+        records.push_back(&pair);
+    }
+
+    size_t size = recordSize();
+    size_t threads = max<size_t>(options.threads, 1);
+    size_t perShard = max<size_t>(options.bufferSize / size, 1);
+    size_t perRound = perShard * threads;
+
+    vector<vector<char>> buffers(threads);
+    bool ok = true;
+
+    for (size_t start = 0; start < records.size() && ok; start += perRound)
+    {
+        vector<thread> workers;
+
+        for (size_t t = 0; t < threads; t++)
         {
-            int16_t move = moveEntry.move.encode();
-            stream.write(reinterpret_cast<const char*>(&move), sizeof(int16_t)); // Encoded move
+            size_t first = min(start + t * perShard, records.size());
+            size_t last = min(first + perShard, records.size());
+
+            buffers[t].resize((last - first) * size);
+
+            auto serialize = [this, &records, &buffers, t, first, last, size]()
+            {
+                char* out = buffers[t].data();
+
+                for (size_t i = first; i < last; i++, out += size)
+                {
+                    serializeRecord(records[i]->first, records[i]->second, out);
+                }
+            };
+
+            if (t + 1 == threads)
+            {
+                serialize();
+            }
+            else if (first < last)
+            {
+                workers.emplace_back(serialize);
+            }
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        for (const auto& buffer : buffers)
+        {
+            if (!buffer.empty() && !file.write(buffer.data(), buffer.size()))
+            {
+                ok = false;
+                break;
+            }
         }
     }
+
+    return file.close(options.sync) && ok;
+}
+
+bool Book::write_blocked(const string& path, const BookWriteOptions& options)
+{
+    struct KeyedRecord
+    {
+        uint64_t key;
+        const Board* board;
+        const MoveList* entries;
+    };
+
+    bool keysOnly = options.format == COMPACT_FORMAT;
+    if (!keyed->empty() && !keysOnly)
+    {
+        return false;
+    }
+
+    vector<KeyedRecord> records;
+    records.reserve(book->size() + keyed->size());
+
+    for (const auto& pair : *book)
+    {
+        records.push_back({ zobristKey(pair.first), &pair.first, &pair.second });
+    }
+
+    for (const auto& pair : *keyed)
+    {
+        records.push_back({ pair.first, nullptr, &pair.second });
+    }
+
+    // Colliding keys are ordered by board bytes so output stays deterministic
+    sort(records.begin(), records.end(), [](const KeyedRecord& a, const KeyedRecord& b)
+    {
+        if (a.key != b.key || a.board == nullptr || b.board == nullptr)
+        {
+            return a.key < b.key;
+        }
+
+        return memcmp(a.board->representation(), b.board->representation(), 64) < 0;
+    });
+
+    if (!options.keepVariations)
+    {
+        variations = min(variations, pgns);
+    }
+
+    BlockBookWriter writer;
+    uint16_t flags = (keysOnly ? BLOCK_KEYS_ONLY : 0) | (options.packed ? BLOCK_PACKED : 0);
+    if (!writer.open(path, variations, moves, options.blockSize, flags, options.direct, options.generation))
+    {
+        return false;
+    }
+
+    Board none;
+
+    for (const auto& record : records)
+    {
+        if (!writer.add(record.key, record.board != nullptr ? *record.board : none, *record.entries))
+        {
+            writer.close(false);
+            return false;
+        }
+    }
+
+    return writer.close(options.sync);
 }
 
 void Book::read_book(ifstream& stream)
 {
-    book.clear();
+    resetTable();
     stream.read(reinterpret_cast<char*>(&variations), sizeof(variations));
     stream.read(reinterpret_cast<char*>(&moves), sizeof(moves));
 
@@ -76,32 +314,386 @@ void Book::read_book(ifstream& stream)
         Board board;
         board.decode(boardData);
 
-        vector<MoveEntry> entries;
+        MoveList entries;
         int16_t moveBin = 0;
 
         for (int i = 0; i < variations; i++)
         {
             stream.read(reinterpret_cast<char*>(&moveBin), sizeof(moveBin));
             Move move = Move::decode(moveBin);
+            if (move.isNull())
+            {
+                continue;
+            }
 
             MoveEntry entry(move, 0);
             entries.push_back(entry);
         }
 
-        book[board] = entries;
+        entriesFor(board) = entries;
+    }
+}
+
+// Maps the file and splits the fixed-size records into one contiguous slice
+// per thread. Workers decode their slice into ready-made entries while the
+// calling thread moves finished slices, in order, into a table pre-sized
+// from the file length. unordered_map cannot take concurrent inserts, so
+// insertion is pipelined behind the decoders rather than run in parallel.
+bool Book::read_book(const string& path, size_t threads)
+{
+    MappedFile file;
+    size_t headerSize = sizeof(variations) + sizeof(moves);
+
+    if (!file.open(path) || file.size() < headerSize)
+    {
+        return false;
+    }
+
+    if (isBlockBook(file.data(), file.size()))
+    {
+        file.close();
+        return read_blocked(path, threads);
+    }
+
+    const char* data = file.data();
+    size_t fileVariations;
+    memcpy(&fileVariations, data, sizeof(fileVariations));
+
+    // Writers store at most UINT8_MAX moves per position; anything above is
+    // a corrupt header, rejected before a worker would reserve by it. A file
+    // with records must hold at least one whole record.
+    size_t payload = file.size() - headerSize;
+
+    if (fileVariations > UINT8_MAX || (payload > 0 && 32 + fileVariations * sizeof(int16_t) > payload))
+    {
+        return false;
+    }
+
+    file.adviseSequential();
+    resetTable();
+    paged.reset();
+
+    variations = fileVariations;
+    memcpy(&moves, data + sizeof(variations), sizeof(moves));
+
+    size_t size = recordSize();
+    size_t count = payload / size;
+    const char* records = data + headerSize;
+
+    book->reserve(count);
+
+    typedef vector<pair<Board, MoveList>> Slice;
+
+    threads = max<size_t>(min(threads, count), 1);
+    size_t perSlice = (count + threads - 1) / threads;
+
+    vector<Slice> slices(threads);
+    vector<thread> workers;
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        size_t first = min(t * perSlice, count);
+        size_t last = min(first + perSlice, count);
+
+        workers.emplace_back([this, &slices, records, size, t, first, last]()
+        {
+            Slice& slice = slices[t];
+            slice.reserve(last - first);
+
+            for (size_t i = first; i < last; i++)
+            {
+                const char* record = records + i * size;
+
+                slice.emplace_back();
+                slice.back().first.decode(record);
+
+                MoveList& entries = slice.back().second;
+                entries.reserve(variations);
+
+                for (size_t v = 0; v < variations; v++)
+                {
+                    int16_t moveBin;
+                    memcpy(&moveBin, record + 32 + v * sizeof(int16_t), sizeof(moveBin));
+
+                    Move move = Move::decode(moveBin);
+                    if (!move.isNull())
+                    {
+                        entries.push_back(MoveEntry(move, 0));
+                    }
+                }
+            }
+        });
+    }
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        workers[t].join();
+
+        for (auto& record : slices[t])
+        {
+            entriesFor(record.first) = std::move(record.second);
+        }
+
+        Slice().swap(slices[t]);
     }
+
+    return true;
 }
 
-void Book::insert(const Board& _board, const Move& move)
+bool Book::read_blocked(const string& path, size_t threads)
 {
-    vector<MoveEntry>& entries = book[_board];
+    BlockBookReader reader;
+    if (!reader.open(path, 0))
+    {
+        return false;
+    }
+
+    resetTable();
+    paged.reset();
+
+    if (reader.keysOnly())
+    {
+        keyed->reserve(reader.records());
+    }
+    else
+    {
+        book->reserve(reader.records());
+    }
+
+    variations = reader.variations();
+    moves = reader.moves();
+
+    size_t blocks = reader.blockCount();
+    threads = max<size_t>(min(threads, blocks), 1);
+    size_t perSlice = (blocks + threads - 1) / threads;
+
+    vector<vector<PagedBlock>> slices(threads);
+    vector<thread> workers;
+    atomic<bool> corrupt(false);
+
+    // Each worker checks a block's CRC right before decoding it, while the
+    // bytes are already being pulled in
+    for (size_t t = 0; t < threads; t++)
+    {
+        size_t first = min(t * perSlice, blocks);
+        size_t last = min(first + perSlice, blocks);
+
+        workers.emplace_back([&reader, &slices, &corrupt, t, first, last]()
+        {
+            for (size_t i = first; i < last && !corrupt; i++)
+            {
+                if (!reader.verifyBlock(i))
+                {
+                    corrupt = true;
+                    break;
+                }
+
+                slices[t].push_back(reader.decodeBlock(i));
+
+                // The board encoding has no side to move, the key does. Boards
+                // decode with white to move, so they keep the key only then.
+                for (auto& record : slices[t].back())
+                {
+                    if (!reader.keysOnly())
+                    {
+                        record.board.setWhiteToMove(zobristKey(record.board) == record.key);
+                    }
+                }
+            }
+        });
+    }
+
+    for (size_t t = 0; t < threads; t++)
+    {
+        workers[t].join();
+
+        if (corrupt)
+        {
+            continue;
+        }
+
+        for (auto& block : slices[t])
+        {
+            for (auto& record : block)
+            {
+                if (reader.keysOnly())
+                {
+                    keyed->try_emplace(record.key, MoveList::allocator_type(&arena)).first->second = std::move(record.entries);
+                }
+                else
+                {
+                    entriesFor(record.board) = std::move(record.entries);
+                }
+            }
+        }
+
+        vector<PagedBlock>().swap(slices[t]);
+    }
+
+    if (corrupt)
+    {
+        resetTable();
+        return false;
+    }
+
+    return true;
+}
+
+// Keeps only the block index resident; positions are decoded block by block
+// on first probe and held in an LRU of at most 'cacheBlocks' blocks.
+bool Book::read_book_paged(const string& path, size_t cacheBlocks, HugePages hugePages)
+{
+    shared_ptr<BlockBookReader> reader = make_shared<BlockBookReader>();
+    if (!reader->open(path, cacheBlocks, hugePages))
+    {
+        return false;
+    }
+
+    resetTable();
+    variations = reader->variations();
+    moves = reader->moves();
+    paged = reader;
+
+    return true;
+}
+
+// Picks up <path>.idx as the position index when make wrote one.
+//
+// Residency options: the in-memory table is fully written while loading, so
+// only huge pages and locking apply to it. A paged book's mapped file is
+// what cold probes fault on; it can be faulted in before returning, locked,
+// or warmed by a detached thread that keeps the reader alive while it runs.
+// A failed lock does not fail the load, see isLocked().
+bool Book::load(const string& path, const BookLoadOptions& options)
+{
+    arena.setHugePages(options.paged ? HUGE_PAGES_OFF : options.hugePages);
+    locked = false;
+
+    bool loaded = options.paged ? read_book_paged(path, options.cacheBlocks, options.hugePages) : read_book(path, options.threads);
+
+    if (!loaded)
+    {
+        return false;
+    }
+
+    openIndex(path + ".idx");
+
+    if (paged)
+    {
+        if (options.lock)
+        {
+            locked = paged->lock();
+        }
+        else if (options.prefault)
+        {
+            paged->prefault();
+        }
+
+        if (options.warm && !options.lock && !options.prefault)
+        {
+            shared_ptr<BlockBookReader> reader = paged;
+            thread([reader]() { reader->prefault(); }).detach();
+        }
+    }
+    else if (options.lock)
+    {
+        locked = arena.lock();
+    }
+
+    return true;
+}
+
+bool Book::isLocked() const
+{
+    return locked;
+}
+
+bool Book::openIndex(const string& path)
+{
+    shared_ptr<PositionIndex> opened = make_shared<PositionIndex>();
+    index = opened->open(path) ? opened : nullptr;
+
+    return index != nullptr;
+}
+
+const PositionIndex* Book::gameIndex() const
+{
+    return index.get();
+}
+
+// The key is only computed for the key-addressed tables; the in-memory
+// board table hashes inside its own lookup.
+shared_ptr<const MoveList> Book::find(const Board& board) const
+{
+    uint64_t key = 0;
+
+    if (paged || !keyed->empty())
+    {
+        PhaseTimer timer(PHASE_HASH);
+        key = zobristKey(board);
+    }
+
+    PhaseTimer timer(PHASE_LOOKUP);
+    shared_ptr<const MoveList> entries = lookup(board, key);
+    timer.setHit(entries != nullptr);
+
+    return entries;
+}
+
+shared_ptr<const MoveList> Book::lookup(const Board& board, uint64_t key) const
+{
+    if (paged)
+    {
+        return paged->find(key, board);
+    }
+
+    if (!keyed->empty())
+    {
+        auto it = keyed->find(key);
+        if (it == keyed->end())
+        {
+            return nullptr;
+        }
+
+        return shared_ptr<const MoveList>(shared_ptr<const void>(), &it->second);
+    }
+
+    auto it = book->find(board);
+    if (it == book->end())
+    {
+        return nullptr;
+    }
+
+    // Non-owning: the entries live in the table
+    return shared_ptr<const MoveList>(shared_ptr<const void>(), &it->second);
+}
+
+// A table loaded from a compact book is keyed by zobristKey, so updates to
+// it go to the keyed map rather than starting a second board table.
+void Book::insert(const Board& _board, const Move& move, uint32_t count)
+{
+    if (shards > 1 && keyShard(zobristKey(_board), shards) != shard)
+    {
+        return;
+    }
+
+    MoveList& entries = keyed->empty()
+        ? entriesFor(_board)
+        : keyed->try_emplace(zobristKey(_board), MoveList::allocator_type(&arena)).first->second;
+
+    if (bounded)
+    {
+        insertBounded(entries, move, count);
+        return;
+    }
+
     bool found = false;
 
     for (auto& entry : entries)
     {
-        if (entry.move.encode() == move.encode())
+        if (entry.move.cmp(move))
         {
-            entry.count += 1;
+            entry.count += count;
             found = true;
             break;
         }
@@ -109,11 +701,74 @@ void Book::insert(const Board& _board, const Move& move)
 
     if (!found)
     {
-        MoveEntry newEntry(move, 1);
+        MoveEntry newEntry(move, count);
         entries.push_back(newEntry);
     }
 }
 
+// Space-saving (Metwally et al.): when the candidate set is full, an unseen
+// move evicts the current minimum and inherits its count as error.
+void Book::insertBounded(MoveList& entries, const Move& move, uint32_t count)
+{
+    size_t capacity = max<size_t>(variations * BOUNDED_FACTOR, 1);
+    size_t minIndex = 0;
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].move.cmp(move))
+        {
+            entries[i].count += count;
+            return;
+        }
+
+        if (entries[i].count < entries[minIndex].count)
+        {
+            minIndex = i;
+        }
+    }
+
+    if (entries.size() < capacity)
+    {
+        if (entries.capacity() < capacity)
+        {
+            entries.reserve(capacity);
+        }
+
+        entries.push_back(MoveEntry(move, count));
+        return;
+    }
+
+    MoveEntry& victim = entries[minIndex];
+    victim.error = victim.count;
+    victim.count += count;
+    victim.move = move;
+}
+
+// Adds the counts of another in-memory table to this one, e.g. per-depth
+// partial tables of a multi-configuration build.
+void Book::merge(const Book& other)
+{
+    for (const auto& pair : *other.book)
+    {
+        MoveList& entries = entriesFor(pair.first);
+
+        for (const auto& added : pair.second)
+        {
+            auto it = find_if(entries.begin(), entries.end(),
+                [&](const MoveEntry& entry) { return entry.move.cmp(added.move); });
+
+            if (it == entries.end())
+            {
+                entries.push_back(added);
+                continue;
+            }
+
+            it->count += added.count;
+            it->error += added.error;
+        }
+    }
+}
+
 void Book::setVariations(size_t _variations) 
 {
     variations = _variations;
@@ -124,20 +779,44 @@ void Book::setMoveCount(size_t _moves)
     moves = _moves;
 }
 
-Move Book::getRankedMove(const Board& board, unsigned int rank)
+void Book::setBounded(bool _bounded)
+{
+    bounded = _bounded;
+}
+
+void Book::setGameCount(size_t games)
 {
-    auto it = book.find(board);
+    pgns = games;
+}
+
+// Restricts inserts to positions whose key falls in shard 'shard' of
+// 'shards' (see keyShard); one shard of one means the whole book.
+void Book::setShard(uint32_t _shard, uint32_t _shards)
+{
+    shard = _shard;
+    shards = max<uint32_t>(_shards, 1);
+}
+
+size_t Book::getVariations() const
+{
+    return variations;
+}
+
+size_t Book::getMoveCount() const
+{
+    return moves;
+}
+
+Move Book::getRankedMove(const Board& board, unsigned int rank) const
+{
+    shared_ptr<const MoveList> entries = find(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(entries && entries->size() > rank);
 
-    if (it != book.end()) 
+    if (entries && entries->size() > rank) 
     {
-        if (it->second.size() > rank) 
-        {
-            return (it->second)[rank].move;
-        }
-        else 
-        {
-            return Move::null();
-        }
+        return (*entries)[rank].move;
     }
     else
     {
@@ -145,26 +824,181 @@ Move Book::getRankedMove(const Board& board, unsigned int rank)
     }
 }
 
-Move Book::getRandMove(const Board& board)
+// Probes may run concurrently on a published book, so each thread samples
+// from its own generator.
+Move Book::getRandMove(const Board& board) const
 {
-    auto it = book.find(board);
+    static thread_local RandomNumberGenerator rng;
+
+    shared_ptr<const MoveList> entries = find(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(entries && !entries->empty());
 
-    if (it != book.end()) {
-        size_t rank = rng.generateByteNumber() % book[board].size();
-        return (it->second)[rank].move;
+    if (entries && !entries->empty()) 
+    {
+        size_t rank = static_cast<unsigned char>(rng.generateByteNumber()) % entries->size();
+        return (*entries)[rank].move;
     }
     else 
     {
         return Move::null();
     }
-    
+}
+
+// Bloom filter over the table's keys, letting callers that consult several
+// books (LayeredBook) skip this one without touching the table. Keys follow
+// each table's equality: placement only for boards, zobristKey otherwise.
+// Paged books are not scanned; they carry a filter over their record keys
+// in the file (block_book.h).
+void Book::buildFilter(double falsePositiveRate)
+{
+    if (paged)
+    {
+        return;
+    }
+
+    filter = BloomFilter(book->size() + keyed->size(), falsePositiveRate);
+
+    for (const auto& pair : *book)
+    {
+        filter.add(BoardHash()(pair.first));
+    }
+
+    for (const auto& pair : *keyed)
+    {
+        filter.add(pair.first);
+    }
+}
+
+bool Book::mayContain(const Board& board) const
+{
+    if (paged)
+    {
+        return paged->mayContain(zobristKey(board));
+    }
+
+    if (filter.isEmpty())
+    {
+        return true;
+    }
+
+    return filter.mayContain(keyed->empty() ? BoardHash()(board) : zobristKey(board));
+}
+
+// Looks up every child of 'board' reached by 'candidates' in one pass.
+// Independent lookups are split into stages (hash all children, read each
+// bucket's head and prefetch its first node, then compare keys) so the cache
+// misses of different children overlap instead of being paid one by one.
+// Only the nodes are prefetched: reading a bucket head is a demand load, as
+// unordered_map does not expose its bucket slots, but the reads do not
+// depend on each other and are issued back to back.
+vector<ChildHit> Book::probeChildren(const Board& board, const vector<Move>& candidates) const
+{
+    size_t count = candidates.size();
+    vector<Board> children(count, board);
+    vector<uint64_t> keys(count);
+    vector<size_t> buckets(count);
+    vector<ChildHit> hits;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        children[i].makeMove(candidates[i]);
+    }
+
+    if (paged)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            shared_ptr<const MoveList> entries = paged->find(zobristKey(children[i]), children[i]);
+            if (entries)
+            {
+                hits.push_back({ candidates[i], entries });
+            }
+        }
+
+        return hits;
+    }
+
+    bool byKey = !keyed->empty();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (byKey)
+        {
+            keys[i] = zobristKey(children[i]);
+            buckets[i] = keyed->bucket(keys[i]);
+        }
+        else
+        {
+            buckets[i] = book->bucket(children[i]);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (byKey)
+        {
+            auto node = keyed->begin(buckets[i]);
+            if (node != keyed->end(buckets[i]))
+            {
+                prefetch(&*node);
+            }
+        }
+        else
+        {
+            auto node = book->begin(buckets[i]);
+            if (node != book->end(buckets[i]))
+            {
+                prefetch(&*node);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const MoveList* entries = nullptr;
+
+        if (byKey)
+        {
+            for (auto node = keyed->begin(buckets[i]); node != keyed->end(buckets[i]); ++node)
+            {
+                if (node->first == keys[i])
+                {
+                    entries = &node->second;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            for (auto node = book->begin(buckets[i]); node != book->end(buckets[i]); ++node)
+            {
+                if (node->first == children[i])
+                {
+                    entries = &node->second;
+                    break;
+                }
+            }
+        }
+
+        if (entries != nullptr)
+        {
+            prefetch(entries->data());
+            hits.push_back({ candidates[i], shared_ptr<const MoveList>(shared_ptr<const void>(), entries) });
+        }
+    }
+
+    return hits;
 }
 
 void Book::clear() 
 {
-    book.clear();
+    resetTable();
+    paged.reset();
 
     pgns = 0;
     variations = 0;
     moves = 0;
+    bounded = false;
 }
@@ -2,44 +2,157 @@
 
 #include "utils/zobrist.h"
 #include "utils/rng.h"
+#include "utils/file_io.h"
+#include "utils/mapped_file.h"
+#include "utils/arena.h"
+#include "utils/prefetch.h"
+#include "utils/bloom_filter.h"
+#include "utils/latency.h"
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <memory>
 #include "pgn.h"
+#include "game_archive.h"
+#include "position_index.h"
 
 using namespace std;
 
 struct MoveEntry
 {
-    unsigned char count;
+    uint32_t count;
+    uint32_t error; // Space-saving overestimate bound, count - error <= true count
     Move move;
 
-    MoveEntry(Move _move, unsigned char _count);
+    MoveEntry(Move _move, uint32_t _count);
     MoveEntry();
 };
 
+typedef vector<MoveEntry, ArenaAllocator<MoveEntry>> MoveList;
+typedef unordered_map<Board, MoveList, BoardHash, equal_to<Board>, ArenaAllocator<pair<const Board, MoveList>>> BookMap;
+
+// Zobrist keys are already uniformly distributed
+struct KeyHash
+{
+    size_t operator()(uint64_t key) const { return static_cast<size_t>(key); }
+};
+
+typedef unordered_map<uint64_t, MoveList, KeyHash, equal_to<uint64_t>, ArenaAllocator<pair<const uint64_t, MoveList>>> KeyMap;
+
+// In bounded mode each position keeps at most variations * BOUNDED_FACTOR
+// candidates, so any reply seen more than 1/(variations * BOUNDED_FACTOR)
+// of the time at a position is guaranteed to survive.
+constexpr size_t BOUNDED_FACTOR = 4;
+
+enum BookFormat
+{
+    LEGACY_FORMAT, // Fixed-size records in table order
+    BLOCK_FORMAT,  // Key-sorted blocks with a resident index, see block_book.h
+    COMPACT_FORMAT // BLOCK_FORMAT storing only the 64-bit key per position
+};
+
+struct BookWriteOptions
+{
+    BookFormat format = LEGACY_FORMAT;
+    size_t threads = 1;
+    size_t bufferSize = 8 << 20; // Per-thread serialization buffer
+    uint32_t blockSize = 64 << 10; // Target block size for BLOCK_FORMAT
+    bool packed = false;         // Bit-packed block records (BLOCK_PACKED)
+    bool keepVariations = false; // No cap at the games inserted (files do not store a game count)
+    uint32_t generation = 0;     // Stamped into block headers (see BookLearner)
+    bool direct = false;         // O_DIRECT where supported
+    bool sync = false;           // fsync before returning
+};
+
+struct ChildHit
+{
+    Move move;                         // Candidate reply that was applied
+    shared_ptr<const MoveList> entries; // Book moves of the resulting position
+};
+
+constexpr size_t DEFAULT_CACHE_BLOCKS = 1024;
+
+struct BookLoadOptions
+{
+    size_t threads = 1;
+    bool paged = false; // Keep only the block index resident
+    size_t cacheBlocks = DEFAULT_CACHE_BLOCKS; // Decoded block LRU size when paged
+    HugePages hugePages = HUGE_PAGES_OFF; // Backing of the table, or of the mapped file when paged
+    bool prefault = false; // Fault the mapped file in before load returns
+    bool lock = false;     // mlock the table or the mapped file
+    bool warm = false;     // Fault the mapped file in on a background thread
+};
+
+class BlockBookReader;
+
 class Book
 {
 private:
     static bool cmpMoveEntry(const MoveEntry& a, const MoveEntry& b);
-    unordered_map<Board, vector<MoveEntry>, BoardHash> book;
-    RandomNumberGenerator rng;
+
+    // The tables and all of their nodes, buckets and move lists live in 'arena',
+    // so they are discarded with the arena instead of being destroyed node by
+    // node. 'keyed' holds books loaded from COMPACT_FORMAT, which have no boards.
+    Arena arena;
+    alignas(BookMap) unsigned char storage[sizeof(BookMap)];
+    alignas(KeyMap) unsigned char keyedStorage[sizeof(KeyMap)];
+    BookMap* book;
+    KeyMap* keyed;
+
     size_t variations;
     size_t moves;
     size_t pgns;
+    bool bounded;
+    bool locked;
+    uint32_t shard;
+    uint32_t shards;
+    shared_ptr<BlockBookReader> paged;
+    shared_ptr<PositionIndex> index;
+    BloomFilter filter;
+
+    void resetTable();
+    MoveList& entriesFor(const Board& board);
+    void insertBounded(MoveList& entries, const Move& move, uint32_t count);
+    size_t recordSize() const;
+    void serializeRecord(const Board& board, const MoveList& entries, char* out) const;
+    bool write_blocked(const string& path, const BookWriteOptions& options);
+    bool read_blocked(const string& path, size_t threads);
+    shared_ptr<const MoveList> lookup(const Board& board, uint64_t key) const;
 
 public:
     Book(size_t variations, size_t count);
+    ~Book();
+
+    Book(const Book&) = delete;
+    Book& operator=(const Book&) = delete;
 
     void insertFromPgn(const Pgn& pgn);
+    void insertFromArchive(const ArchivedGame& game);
     void resize_vector(size_t size);
     void write_book(ostream& stream);
+    bool write_book(const string& path, const BookWriteOptions& options);
     void read_book(ifstream& stream);
-    void insert(const Board& board, const Move& move);
+    bool read_book(const string& path, size_t threads);
+    bool read_book_paged(const string& path, size_t cacheBlocks, HugePages hugePages = HUGE_PAGES_OFF);
+    bool load(const string& path, const BookLoadOptions& options);
+    bool openIndex(const string& path);
+    const PositionIndex* gameIndex() const;
+    bool isLocked() const;
+    void insert(const Board& board, const Move& move, uint32_t count = 1);
+    void merge(const Book& other);
     void setVariations(size_t variations);
     void setMoveCount(size_t moves);
-    Move getRankedMove(const Board& board, unsigned int rank);
-    Move getRandMove(const Board& board);
+    void setBounded(bool bounded);
+    void setGameCount(size_t games);
+    void setShard(uint32_t shard, uint32_t shards);
+    size_t getVariations() const;
+    size_t getMoveCount() const;
+    Move getRankedMove(const Board& board, unsigned int rank) const;
+    Move getRandMove(const Board& board) const;
+    shared_ptr<const MoveList> find(const Board& board) const;
+    void buildFilter(double falsePositiveRate);
+    bool mayContain(const Board& board) const;
+    vector<ChildHit> probeChildren(const Board& board, const vector<Move>& candidates) const;
     void clear();
 };
@@ -0,0 +1,330 @@
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "utils/zobrist.h"
+#include "book_graph.h"
+
+using namespace std;
+
+constexpr size_t VISITED_SHARDS = 64;
+constexpr size_t RANGE_SIZE = 32; // Positions per stealable range
+
+struct GraphNode
+{
+    Board board;
+    double lines;
+    size_t stop; // Ply at which the roots leading here stop expanding
+};
+
+struct Visit
+{
+    size_t ply;
+    uint32_t slot; // Index into the shard's next level while ply is the next one
+};
+
+struct VisitedShard
+{
+    mutex lock;
+    unordered_map<uint64_t, Visit> visits;
+    vector<GraphNode> next;
+};
+
+// Ranges of the current level, one deque per worker
+class WorkQueues
+{
+private:
+    struct Queue
+    {
+        mutex lock;
+        deque<pair<size_t, size_t>> ranges;
+    };
+
+    vector<Queue> queues;
+
+    bool take(Queue& queue, bool back, pair<size_t, size_t>& range)
+    {
+        lock_guard<mutex> guard(queue.lock);
+
+        if (queue.ranges.empty())
+        {
+            return false;
+        }
+
+        range = back ? queue.ranges.back() : queue.ranges.front();
+        back ? queue.ranges.pop_back() : queue.ranges.pop_front();
+        return true;
+    }
+
+public:
+    explicit WorkQueues(size_t workers) : queues(workers) {}
+
+    // Contiguous ranges per worker, so neighbouring positions stay together
+    // until someone steals them
+    void fill(size_t count)
+    {
+        size_t ranges = (count + RANGE_SIZE - 1) / RANGE_SIZE;
+
+        for (size_t r = 0; r < ranges; r++)
+        {
+            size_t owner = r * queues.size() / ranges;
+            queues[owner].ranges.emplace_back(r * RANGE_SIZE, min(count, (r + 1) * RANGE_SIZE));
+        }
+    }
+
+    bool next(size_t worker, pair<size_t, size_t>& range)
+    {
+        if (take(queues[worker], true, range))
+        {
+            return true;
+        }
+
+        for (size_t i = 1; i < queues.size(); i++)
+        {
+            if (take(queues[(worker + i) % queues.size()], false, range))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+static VisitedShard& shardOf(vector<VisitedShard>& shards, uint64_t key)
+{
+    return shards[key >> 58];
+}
+
+static_assert(VISITED_SHARDS == 64, "shardOf takes the top six key bits");
+
+// The origin must hold a piece of the side to move and the target must not
+static bool playable(const Board& board, const Move& move)
+{
+    if (move.isNull())
+    {
+        return false;
+    }
+
+    const char* squares = board.representation();
+    char piece = squares[static_cast<unsigned char>(move.fromSquare())];
+    char target = squares[static_cast<unsigned char>(move.toSquare())];
+
+    auto own = [&](char p) { return p != NN && (p < BP) == board.whiteToMove(); };
+    return own(piece) && !own(target);
+}
+
+// Queues a position for 'ply' unless it was reached before; the caller holds
+// the shard's lock. False for a transposition into an earlier ply.
+static bool enter(VisitedShard& shard, uint64_t key, size_t ply, const Board& board, double lines, size_t stop)
+{
+    auto [it, inserted] = shard.visits.try_emplace(key, Visit{ ply, static_cast<uint32_t>(shard.next.size()) });
+
+    if (inserted)
+    {
+        shard.next.push_back({ board, lines, stop });
+        return true;
+    }
+
+    if (it->second.ply != ply)
+    {
+        return false;
+    }
+
+    GraphNode& node = shard.next[it->second.slot];
+    node.lines += lines;
+    node.stop = max(node.stop, stop);
+    return true;
+}
+
+static void addSample(mutex& lock, vector<string>& samples, size_t limit, const Board& board, const Move& move)
+{
+    lock_guard<mutex> guard(lock);
+
+    if (samples.size() < limit)
+    {
+        samples.push_back(board.toFen() + " " + move.toUci());
+    }
+}
+
+GraphReport traverseBook(const Book& book, const vector<GraphRoot>& roots, const GraphOptions& options)
+{
+    GraphReport report = {};
+    report.roots = roots.size();
+
+    vector<VisitedShard> shards(VISITED_SHARDS);
+    vector<GraphRoot> pending;
+
+    for (const auto& root : roots)
+    {
+        if (!book.find(root.board))
+        {
+            report.missingRoots.push_back(root.board.toFen());
+        }
+        else if (options.depth > 0)
+        {
+            pending.push_back(root);
+        }
+    }
+
+    // Later roots are taken off the back as the walk reaches their ply
+    sort(pending.begin(), pending.end(), [](const GraphRoot& a, const GraphRoot& b) { return a.ply > b.ply; });
+
+    size_t horizon = book.getMoveCount();
+    size_t workers = max<size_t>(options.threads, 1);
+    mutex sampleLock;
+    vector<GraphNode> level;
+
+    for (size_t ply = 0; ; ply++)
+    {
+        bool queued = any_of(shards.begin(), shards.end(), [](const VisitedShard& shard) { return !shard.next.empty(); });
+
+        if (!queued)
+        {
+            if (pending.empty())
+            {
+                break;
+            }
+
+            ply = pending.back().ply;
+        }
+
+        while (!pending.empty() && pending.back().ply == ply)
+        {
+            const GraphRoot& root = pending.back();
+            uint64_t key = zobristKey(root.board);
+            size_t stop = options.depth > SIZE_MAX - ply ? SIZE_MAX : ply + options.depth;
+
+            enter(shardOf(shards, key), key, ply, root.board, 1, stop);
+            pending.pop_back();
+        }
+
+        for (auto& shard : shards)
+        {
+            level.insert(level.end(), shard.next.begin(), shard.next.end());
+            shard.next.clear();
+        }
+
+        GraphDepth stats = { ply, level.size(), 0, 0, 0, 0 };
+
+        for (const auto& node : level)
+        {
+            stats.lines += node.lines;
+        }
+
+        bool atHorizon = ply + 1 >= horizon;
+
+        WorkQueues queues(workers);
+        queues.fill(level.size());
+
+        atomic<size_t> moves(0), exits(0), deadEnds(0), broken(0), transpositions(0);
+        vector<thread> pool;
+
+        for (size_t w = 0; w < workers; w++)
+        {
+            pool.emplace_back([&, w]()
+            {
+                size_t localMoves = 0, localExits = 0, localDeadEnds = 0, localBroken = 0, localTranspositions = 0;
+                pair<size_t, size_t> range;
+                vector<Move> candidates;
+
+                while (queues.next(w, range))
+                {
+                    for (size_t i = range.first; i < range.second; i++)
+                    {
+                        const GraphNode& node = level[i];
+                        shared_ptr<const MoveList> entries = book.find(node.board);
+
+                        if (!entries)
+                        {
+                            continue;
+                        }
+
+                        candidates.clear();
+
+                        for (const auto& entry : *entries)
+                        {
+                            if (!playable(node.board, entry.move))
+                            {
+                                localBroken++;
+                                addSample(sampleLock, report.brokenSamples, options.samples, node.board, entry.move);
+                                continue;
+                            }
+
+                            candidates.push_back(entry.move);
+                        }
+
+                        localMoves += entries->size();
+                        vector<ChildHit> hits = book.probeChildren(node.board, candidates);
+
+                        for (const auto& move : candidates)
+                        {
+                            bool inBook = any_of(hits.begin(), hits.end(), [&](const ChildHit& hit) { return hit.move.cmp(move); });
+
+                            if (!inBook)
+                            {
+                                if (atHorizon)
+                                {
+                                    localExits++;
+                                }
+                                else
+                                {
+                                    localDeadEnds++;
+                                    addSample(sampleLock, report.deadEndSamples, options.samples, node.board, move);
+                                }
+
+                                continue;
+                            }
+
+                            if (ply + 1 >= node.stop)
+                            {
+                                continue;
+                            }
+
+                            Board child = node.board;
+                            child.makeMove(move);
+
+                            uint64_t key = zobristKey(child);
+                            VisitedShard& shard = shardOf(shards, key);
+                            lock_guard<mutex> guard(shard.lock);
+
+                            if (!enter(shard, key, ply + 1, child, node.lines, node.stop))
+                            {
+                                localTranspositions++;
+                            }
+                        }
+                    }
+                }
+
+                moves += localMoves;
+                exits += localExits;
+                deadEnds += localDeadEnds;
+                broken += localBroken;
+                transpositions += localTranspositions;
+            });
+        }
+
+        for (auto& worker : pool)
+        {
+            worker.join();
+        }
+
+        stats.moves = moves;
+        stats.exits = exits;
+        stats.deadEnds = deadEnds;
+
+        report.positions += stats.positions;
+        report.moves += stats.moves;
+        report.exits += stats.exits;
+        report.deadEnds += stats.deadEnds;
+        report.broken += broken;
+        report.transpositions += transpositions;
+        report.depths.push_back(stats);
+
+        level.clear();
+    }
+
+    return report;
+}
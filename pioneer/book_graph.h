@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "book.h"
+
+using namespace std;
+
+struct GraphRoot
+{
+    Board board;
+    size_t ply; // Plies from the initial position, as in the FEN's move number
+};
+
+struct GraphOptions
+{
+    size_t depth = SIZE_MAX; // Plies from each root
+    size_t threads = 1;
+    size_t samples = 10;     // FENs kept per kind of finding
+};
+
+struct GraphDepth
+{
+    size_t ply;        // Plies from the initial position
+    size_t positions;  // Positions first reached at this ply
+    size_t moves;      // Stored moves of those positions
+    double lines;      // Move sequences from the roots that reach this ply in book
+    size_t exits;      // Moves leaving the book at its move horizon
+    size_t deadEnds;   // Moves leaving the book before it
+};
+
+struct GraphReport
+{
+    size_t roots;
+    size_t positions;
+    size_t moves;
+    size_t transpositions; // Moves into a position first reached at an earlier ply
+    size_t exits;
+    size_t deadEnds;
+    size_t broken;         // Stored moves with no piece of the side to move on their origin
+    vector<GraphDepth> depths;
+    vector<string> deadEndSamples; // "<FEN> <uci_move>"
+    vector<string> brokenSamples;
+    vector<string> missingRoots;
+};
+
+// Walks the book ply by ply from 'roots', applying every stored move with
+// Board::makeMove. Levels are plies from the initial position, so the book's
+// move horizon holds for every root and a root joins the walk at its own
+// ply. Each level is split into ranges of positions on per-worker deques; a
+// worker takes from the back of its own deque and steals from the front of
+// the others' when it runs dry. Positions are claimed in a sharded visited
+// set, so each is expanded once, at the ply it is first reached. Lines
+// meeting in the same position at the same ply are summed there; lines that
+// transpose into a position reached earlier end.
+GraphReport traverseBook(const Book& book, const vector<GraphRoot>& roots, const GraphOptions& options);
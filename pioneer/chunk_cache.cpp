@@ -0,0 +1,239 @@
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#include "utils/mapped_file.h"
+#include "utils/file_io.h"
+#include "utils/crc32c.h"
+#include "chunk_cache.h"
+
+using namespace std;
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+// FNV-1a over 8-byte words; the entry also stores the chunk's CRC32C and
+// length, which are checked before it is used
+static uint64_t hashBytes(uint64_t hash, const char* data, size_t size)
+{
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+
+    for (; i < size; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+void ingestChunk(const string& chunk, const GameFilter& filter, FingerprintSet* seen, MultiBookBuilder& builder, ChunkSummary& summary)
+{
+    FingerprintSet local;
+
+    for (const auto& game : splitGames(chunk))
+    {
+        summary.games++;
+
+        if (!filter.accepts(game))
+        {
+            summary.filtered++;
+            continue;
+        }
+
+        if (seen != nullptr)
+        {
+            uint64_t fingerprint = gameFingerprint(game);
+
+            if (!local.insert(fingerprint))
+            {
+                summary.duplicates++;
+                continue;
+            }
+
+            if (!seen->insert(fingerprint))
+            {
+                summary.duplicates++;
+                summary.earlier.push_back(fingerprint);
+                continue;
+            }
+
+            summary.added.push_back(fingerprint);
+        }
+
+        Pgn pgn{ game };
+
+        if (!pgn.ok())
+        {
+            summary.skipped.add(pgn.status());
+            continue;
+        }
+
+        builder.insertFromPgn(pgn, 0);
+    }
+}
+
+ChunkCache::ChunkCache(const string& _dir, const string& _settings, size_t _threads)
+    : dir(_dir), settings(hashBytes(FNV_OFFSET, _settings.data(), _settings.size())), threads(_threads) {}
+
+bool ChunkCache::open()
+{
+    error_code error;
+    filesystem::create_directories(dir, error);
+
+    return filesystem::is_directory(dir, error);
+}
+
+uint64_t ChunkCache::keyFor(const string& chunk) const
+{
+    return hashBytes(settings, chunk.data(), chunk.size());
+}
+
+string ChunkCache::entryPath(uint64_t key, const string& suffix) const
+{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+    return (filesystem::path(dir) / (string(name) + suffix)).string();
+}
+
+bool ChunkCache::load(const string& chunk, FingerprintSet* seen, ChunkSummary& summary, MultiBookBuilder& builder) const
+{
+    uint64_t key = keyFor(chunk);
+    MappedFile file;
+
+    if (!file.open(entryPath(key, ".meta")) || file.size() < sizeof(ChunkMeta))
+    {
+        return false;
+    }
+
+    ChunkMeta meta;
+    memcpy(&meta, file.data(), sizeof(meta));
+
+    if (memcmp(meta.magic, CHUNK_CACHE_MAGIC, sizeof(meta.magic)) != 0 || meta.version != CHUNK_CACHE_VERSION
+        || meta.settings != settings || meta.size != chunk.size() || meta.partials != builder.partialCount()
+        || file.size() != sizeof(ChunkMeta) + (meta.added + meta.earlier) * sizeof(uint64_t)
+        || meta.crc != crc32c(chunk.data(), chunk.size()))
+    {
+        return false;
+    }
+
+    const char* fingerprints = file.data() + sizeof(ChunkMeta);
+    vector<uint64_t> added(meta.added);
+    vector<uint64_t> earlier(meta.earlier);
+    memcpy(added.data(), fingerprints, added.size() * sizeof(uint64_t));
+    memcpy(earlier.data(), fingerprints + added.size() * sizeof(uint64_t), earlier.size() * sizeof(uint64_t));
+
+    if (seen != nullptr)
+    {
+        for (uint64_t fingerprint : earlier)
+        {
+            if (!seen->contains(fingerprint))
+            {
+                return false;
+            }
+        }
+
+        for (uint64_t fingerprint : added)
+        {
+            if (seen->contains(fingerprint))
+            {
+                return false;
+            }
+        }
+    }
+
+    vector<unique_ptr<Book>> partials;
+
+    for (size_t i = 0; i < builder.partialCount(); i++)
+    {
+        partials.push_back(make_unique<Book>(0, 0));
+
+        if (!partials.back()->read_book(entryPath(key, "." + to_string(i) + ".bin"), threads))
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < partials.size(); i++)
+    {
+        builder.partial(i).merge(*partials[i]);
+    }
+
+    builder.addGames(meta.replayed);
+
+    if (seen != nullptr)
+    {
+        for (uint64_t fingerprint : added)
+        {
+            seen->insert(fingerprint);
+        }
+    }
+
+    summary.games = meta.games;
+    summary.filtered = meta.filtered;
+    summary.duplicates = meta.duplicates;
+
+    for (size_t i = 0; i < PARSE_ERROR_COUNT; i++)
+    {
+        summary.skipped.counts[i] = meta.skipped[i];
+    }
+
+    summary.added = move(added);
+    summary.earlier = move(earlier);
+    return true;
+}
+
+// Partials first and the meta file last, so an entry interrupted halfway has
+// no meta and is a miss
+bool ChunkCache::store(const string& chunk, const ChunkSummary& summary, MultiBookBuilder& builder) const
+{
+    uint64_t key = keyFor(chunk);
+
+    BookWriteOptions options;
+    options.format = BLOCK_FORMAT;
+    options.threads = threads;
+
+    for (size_t i = 0; i < builder.partialCount(); i++)
+    {
+        builder.partial(i).setGameCount(builder.gameCount());
+
+        if (!builder.partial(i).write_book(entryPath(key, "." + to_string(i) + ".bin"), options))
+        {
+            return false;
+        }
+    }
+
+    ChunkMeta meta = {};
+    memcpy(meta.magic, CHUNK_CACHE_MAGIC, sizeof(meta.magic));
+    meta.version = CHUNK_CACHE_VERSION;
+    meta.partials = static_cast<uint16_t>(builder.partialCount());
+    meta.crc = crc32c(chunk.data(), chunk.size());
+    meta.size = chunk.size();
+    meta.settings = settings;
+    meta.games = summary.games;
+    meta.filtered = summary.filtered;
+    meta.duplicates = summary.duplicates;
+    meta.replayed = builder.gameCount();
+    meta.added = summary.added.size();
+    meta.earlier = summary.earlier.size();
+
+    for (size_t i = 0; i < PARSE_ERROR_COUNT; i++)
+    {
+        meta.skipped[i] = summary.skipped.counts[i];
+    }
+
+    OutputFile file;
+
+    return file.open(entryPath(key, ".meta"), false)
+        && file.write(reinterpret_cast<const char*>(&meta), sizeof(meta))
+        && file.write(reinterpret_cast<const char*>(summary.added.data()), summary.added.size() * sizeof(uint64_t))
+        && file.write(reinterpret_cast<const char*>(summary.earlier.data()), summary.earlier.size() * sizeof(uint64_t))
+        && file.close();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/fingerprint_set.h"
+#include "game_filter.h"
+#include "multi_build.h"
+#include "pgn.h"
+
+using namespace std;
+
+// Cache of what each chunk of a PGN file contributed to a make, for files
+// that only ever grow. PgnChunkReader cuts the unchanged part of a file
+// into the same chunks on every run, so only the last old chunk and the new
+// ones are parsed again. Entries are addressed by a hash of the chunk bytes
+// and of the build settings:
+//
+//   <dir>/<key>.meta     ChunkMeta | added * u64 | earlier * u64
+//   <dir>/<key>.<i>.bin  partial table i of the chunk, BLOCK_FORMAT
+//
+// Partial tables keep every move with its count, so the cache serves any
+// number of variations. With deduplication a chunk's partials depend on the
+// games before it; the entry records the fingerprints it added and the ones
+// it dropped as duplicates of earlier chunks, and is only reused while the
+// games seen so far agree with both.
+
+constexpr char CHUNK_CACHE_MAGIC[4] = { 'P', 'N', 'C', 'C' };
+constexpr uint16_t CHUNK_CACHE_VERSION = 1;
+
+struct ChunkMeta
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t partials;
+    uint32_t crc;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t settings;
+    uint64_t games;
+    uint64_t filtered;
+    uint64_t duplicates;
+    uint64_t replayed;
+    uint64_t skipped[PARSE_ERROR_COUNT];
+    uint64_t added;
+    uint64_t earlier;
+};
+
+static_assert(sizeof(ChunkMeta) == 64 + sizeof(uint64_t) * (PARSE_ERROR_COUNT + 2), "ChunkMeta must be packed");
+
+struct ChunkSummary
+{
+    size_t games = 0;
+    size_t filtered = 0;
+    size_t duplicates = 0;
+    ParseErrorCounts skipped;
+    vector<uint64_t> added;   // Fingerprints first seen in this chunk
+    vector<uint64_t> earlier; // Fingerprints dropped as duplicates of earlier chunks
+};
+
+// Filters the games of one chunk, deduplicates them against 'seen' unless it
+// is null, and replays the rest into 'builder'.
+void ingestChunk(const string& chunk, const GameFilter& filter, FingerprintSet* seen, MultiBookBuilder& builder, ChunkSummary& summary);
+
+class ChunkCache
+{
+private:
+    string dir;
+    uint64_t settings;
+    size_t threads;
+
+    uint64_t keyFor(const string& chunk) const;
+    string entryPath(uint64_t key, const string& suffix) const;
+
+public:
+    // 'settings' describes everything besides the chunk that shapes its
+    // partials: depths, filters, deduplication, shard
+    ChunkCache(const string& dir, const string& settings, size_t threads);
+
+    bool open();
+
+    // Merges a cached chunk into 'builder' and adds its fingerprints to
+    // 'seen'. False on a miss or when the entry disagrees with 'seen'.
+    bool load(const string& chunk, FingerprintSet* seen, ChunkSummary& summary, MultiBookBuilder& builder) const;
+    bool store(const string& chunk, const ChunkSummary& summary, MultiBookBuilder& builder) const;
+};
@@ -15,9 +15,189 @@ static bool compareCaseInsensitive(const string& a, const string& b)
 	return lowerStr1 == lowerStr2;
 }
 
+static bool hasFlag(const vector<string>& args, const string& flag)
+{
+	return find(args.begin(), args.end(), flag) != args.end();
+}
+
+static string flagValue(const vector<string>& args, const string& flag, const string& fallback)
+{
+	auto it = find(args.begin(), args.end(), flag);
+
+	if (it == args.end() || (it + 1) == args.end())
+	{
+		return fallback;
+	}
+
+	return *(it + 1);
+}
+
+static vector<string> flagValues(const vector<string>& args, const string& flag)
+{
+	vector<string> values;
+
+	for (size_t i = 0; i + 1 < args.size(); i++)
+	{
+		if (args[i] == flag)
+		{
+			values.push_back(args[i + 1]);
+		}
+	}
+
+	return values;
+}
+
+// "<out_file_name>,<variations>,<moves>"
+static bool parseConfig(const string& spec, BookConfig& config)
+{
+	vector<string> fields = split(spec, ",");
+
+	if (fields.size() != 3 || fields[0].empty())
+	{
+		return false;
+	}
+
+	config.path = fields[0];
+	config.variations = static_cast<size_t>(stoull(fields[1]));
+	config.moves = static_cast<size_t>(stoull(fields[2]));
+	return true;
+}
+
+// "<i>/<n>" with 0 <= i < n
+static bool parseShard(const string& spec, uint32_t& shard, uint32_t& shards)
+{
+	vector<string> fields = split(spec, "/");
+
+	if (fields.size() != 2 || fields[0].empty() || fields[1].empty()
+		|| fields[0].find_first_not_of("0123456789") != string::npos || fields[1].find_first_not_of("0123456789") != string::npos)
+	{
+		return false;
+	}
+
+	shard = static_cast<uint32_t>(stoul(fields[0]));
+	shards = static_cast<uint32_t>(stoul(fields[1]));
+	return shards > 0 && shard < shards;
+}
+
+static bool parseFilter(const vector<string>& args, GameFilter& filter)
+{
+	bool ok = true;
+
+	if (hasFlag(args, "--elo"))
+	{
+		ok = filter.setWhiteElo(flagValue(args, "--elo", "")) && filter.setBlackElo(flagValue(args, "--elo", "")) && ok;
+	}
+
+	if (hasFlag(args, "--white-elo")) ok = filter.setWhiteElo(flagValue(args, "--white-elo", "")) && ok;
+	if (hasFlag(args, "--black-elo")) ok = filter.setBlackElo(flagValue(args, "--black-elo", "")) && ok;
+	if (hasFlag(args, "--time-control")) ok = filter.setTimeControl(flagValue(args, "--time-control", "")) && ok;
+	if (hasFlag(args, "--result")) ok = filter.setResult(flagValue(args, "--result", "")) && ok;
+	if (hasFlag(args, "--date")) ok = filter.setDate(flagValue(args, "--date", "")) && ok;
+	if (hasFlag(args, "--event")) filter.setEvent(flagValue(args, "--event", ""));
+
+	return ok;
+}
+
+// Everything besides the input that shapes a chunk's partial tables
+static string cacheSettings(const vector<string>& args, const vector<BookConfig>& configs, bool dedup, uint32_t shard, uint32_t shards)
+{
+	string settings = "moves";
+
+	for (const auto& config : configs)
+	{
+		settings += " " + to_string(config.moves);
+	}
+
+	settings += dedup ? " dedup" : " keep";
+	settings += " shard " + to_string(shard) + "/" + to_string(shards);
+
+	for (const char* flag : { "--elo", "--white-elo", "--black-elo", "--time-control", "--result", "--date", "--event" })
+	{
+		if (hasFlag(args, flag))
+		{
+			settings += string(" ") + flag + " " + flagValue(args, flag, "");
+		}
+	}
+
+	return settings;
+}
+
+static size_t defaultThreads()
+{
+	return max<size_t>(thread::hardware_concurrency(), 1);
+}
+
+static bool readFen(const string& fen, Board& board)
+{
+	if (Board::parseFen(fen, board) != PARSE_OK)
+	{
+		cout << "Invalid FEN: " << fen << endl;
+		return false;
+	}
+
+	return true;
+}
+
+// Plies from the initial position by the FEN's move number and side to
+// move; a FEN without a move number counts from move 1
+static size_t fenPly(const string& fen, const Board& board)
+{
+	istringstream fields(fen);
+	string field;
+	unsigned long fullmove = 1;
+
+	for (size_t i = 0; fields >> field; i++)
+	{
+		if (i == 5)
+		{
+			fullmove = max(strtoul(field.c_str(), nullptr, 10), 1ul);
+		}
+	}
+
+	return 2 * (fullmove - 1) + (board.whiteToMove() ? 0 : 1);
+}
+
+static bool readMove(const string& uci, Move& move)
+{
+	if (Move::parseUci(uci, move) != PARSE_OK)
+	{
+		cout << "Invalid move: " << uci << endl;
+		return false;
+	}
+
+	return true;
+}
+
+static bool parseProbeFen(const string& fen, Board& board)
+{
+	PhaseTimer timer(PHASE_FEN);
+	bool ok = readFen(fen, board);
+	timer.setHit(ok);
+
+	return ok;
+}
+
+static BookLoadOptions parseLoadOptions(const vector<string>& args)
+{
+	BookLoadOptions options;
+	options.threads = static_cast<size_t>(stoull(flagValue(args, "--threads", to_string(defaultThreads()))));
+	options.paged = hasFlag(args, "--paged");
+	options.cacheBlocks = static_cast<size_t>(stoull(flagValue(args, "--cache", to_string(DEFAULT_CACHE_BLOCKS))));
+
+	string hugePages = flagValue(args, "--huge-pages", "off");
+	options.hugePages = hugePages == "explicit" ? HUGE_PAGES_EXPLICIT : hugePages == "transparent" ? HUGE_PAGES_TRANSPARENT : HUGE_PAGES_OFF;
+	options.prefault = hasFlag(args, "--prefault");
+	options.lock = hasFlag(args, "--mlock");
+	options.warm = hasFlag(args, "--warm");
+
+	return options;
+}
+
 void start_cli()
 {
-	Book book(0, 0);
+	LiveBook live;
+	LayeredBook layers;
+	BookLearner learner(live);
 
 	while (true) 
 	{
@@ -29,12 +209,9 @@ void start_cli()
 		vector<string> _split = split(input, " ");
 		if (compareCaseInsensitive(_split[0], "make"))
 		{
-			book.clear();
-
-
-			if (_split.size() < 3)
+			if (_split.size() < 5)
 			{
-				cout << "Usage: make <pgn_file_name> <out_file_name>" << endl;
+				cout << "Usage: make <pgn_file_name> <out_file_name> <variations> <moves> [--config <out_file_name>,<variations>,<moves> ...] [--bounded] [--keep-duplicates] [<filters>] [--format legacy|blocked|compact] [--packed] [--block-size <bytes>] [--threads <n>] [--direct] [--fsync] [--index] [--shard <i>/<n>] [--cache <dir>]" << endl;
 				continue;
 			}
 
@@ -44,15 +221,288 @@ void start_cli()
 			size_t variations = static_cast<size_t>(stoull(_split[3]));
 			size_t moves = static_cast<size_t>(stoull(_split[4]));
 
-			book.setVariations(variations);
-			book.setMoveCount(moves);
+			vector<BookConfig> configs = { { out_file_name, variations, moves } };
+			bool validConfigs = true;
+
+			for (const auto& spec : flagValues(_split, "--config"))
+			{
+				configs.emplace_back();
+				validConfigs = parseConfig(spec, configs.back()) && validConfigs;
+			}
+
+			if (!validConfigs)
+			{
+				cout << "Invalid book configuration, expected <out_file_name>,<variations>,<moves>." << endl;
+				continue;
+			}
+
+			bool bounded = hasFlag(_split, "--bounded");
+			if (bounded && configs.size() > 1)
+			{
+				cout << "--bounded builds one configuration at a time." << endl;
+				continue;
+			}
+
+			MultiBookBuilder builder(configs, bounded);
+			PositionIndexBuilder positionIndex;
+			bool indexed = hasFlag(_split, "--index");
+
+			if (indexed)
+			{
+				builder.setIndex(&positionIndex, moves);
+			}
+
+			uint32_t shard = 0, shards = 1;
+
+			if (hasFlag(_split, "--shard"))
+			{
+				if (!parseShard(flagValue(_split, "--shard", ""), shard, shards))
+				{
+					cout << "Invalid shard, expected <i>/<n> with 0 <= i < n." << endl;
+					continue;
+				}
+
+				if (flagValue(_split, "--format", "legacy") == "legacy" || indexed)
+				{
+					cout << "Shards are merged by key, write them with --format blocked or compact and without --index." << endl;
+					continue;
+				}
+
+				builder.setShard(shard, shards);
+			}
+
+			GameFilter filter;
+			if (!parseFilter(_split, filter))
+			{
+				cout << "Invalid game filter." << endl;
+				continue;
+			}
+
+			bool cached = hasFlag(_split, "--cache");
+			if (cached && (bounded || indexed))
+			{
+				cout << "--cache keeps exact per-chunk counts, it does not combine with --bounded or --index." << endl;
+				continue;
+			}
+
+			GameArchiveReader archive;
+			size_t total = 0;
+			size_t duplicates = 0;
+			size_t filtered = 0;
+			ParseErrorCounts skipped;
 
-			ofstream out_file(out_file_name, ios::out | ios::trunc);
-			ifstream pgn_file(pgn_file_name);
+			bool archived = archive.open(pgn_file_name);
 
+			// Archives replay without parsing, so only PGN input is cached
+			if (cached && !archived)
+			{
+				bool dedup = !hasFlag(_split, "--keep-duplicates");
+				ChunkCache cache(flagValue(_split, "--cache", ""), cacheSettings(_split, configs, dedup, shard, shards), defaultThreads());
+				PgnChunkReader reader;
+
+				if (!cache.open())
+				{
+					cout << "Error opening cache directory " << flagValue(_split, "--cache", "") << "." << endl;
+					continue;
+				}
+
+				if (!reader.open(pgn_file_name))
+				{
+					cout << "Error opening file " << pgn_file_name << "." << endl;
+					continue;
+				}
+
+				FingerprintSet seen;
+				size_t chunks = 0;
+				size_t reused = 0;
+				string chunk;
+
+				while (reader.next(chunk))
+				{
+					MultiBookBuilder part(configs, false);
+					part.setShard(shard, shards);
+					ChunkSummary summary;
+
+					if (cache.load(chunk, dedup ? &seen : nullptr, summary, part))
+					{
+						reused++;
+					}
+					else
+					{
+						ingestChunk(chunk, filter, dedup ? &seen : nullptr, part, summary);
+
+						if (!cache.store(chunk, summary, part))
+						{
+							cout << "Error writing to cache directory " << flagValue(_split, "--cache", "") << "." << endl;
+						}
+					}
+
+					builder.merge(part);
+					chunks++;
+					total += summary.games;
+					filtered += summary.filtered;
+					duplicates += summary.duplicates;
+					skipped.add(summary.skipped);
+				}
+
+				cout << "Reused " << reused << " of " << chunks << " cached chunks." << endl;
+			}
+			else if (archived)
+			{
+				if (filter.needsTags())
+				{
+					cout << "Game archives only keep Elo and result, apply other filters at convert time." << endl;
+					continue;
+				}
+
+				total = archive.games().size();
+
+				for (size_t i = 0; i < archive.games().size(); i++)
+				{
+					const ArchivedGame& game = archive.games()[i];
+
+					if (!filter.accepts(game))
+					{
+						filtered++;
+						continue;
+					}
+
+					builder.insertFromArchive(game, static_cast<uint32_t>(i));
+				}
+			}
+			else
+			{
+				ifstream pgn_file(pgn_file_name);
+
+				if (!pgn_file.is_open())
+				{
+					cout << "Error opening file " << pgn_file_name << "." << endl;
+					continue;
+				}
+
+				stringstream stream;
+				stream << pgn_file.rdbuf();
+
+				string raw_pgns = stream.str();
+				vector<PgnGame> games = splitGames(raw_pgns);
+				total = games.size();
+
+				bool dedup = !hasFlag(_split, "--keep-duplicates");
+				FingerprintSet seen(dedup ? games.size() : 0);
+
+				for (size_t i = 0; i < games.size(); i++)
+				{
+					const PgnGame& game = games[i];
+
+					if (!filter.accepts(game))
+					{
+						filtered++;
+						continue;
+					}
+
+					if (dedup && !seen.insert(gameFingerprint(game)))
+					{
+						duplicates++;
+						continue;
+					}
+
+					Pgn _pgn{ game };
+
+					if (!_pgn.ok())
+					{
+						skipped.add(_pgn.status());
+						continue;
+					}
+
+					builder.insertFromPgn(_pgn, static_cast<uint32_t>(i));
+				}
+			}
+
+			if (filter.isActive())
+			{
+				cout << "Filtered out " << filtered << " of " << total << " games." << endl;
+			}
+
+			if (duplicates > 0)
+			{
+				cout << "Skipped " << duplicates << " duplicate games." << endl;
+			}
+
+			if (skipped.total() > 0)
+			{
+				cout << "Skipped " << skipped.total() << " games that failed to parse (" << skipped.summary() << ")." << endl;
+			}
+
+			BookWriteOptions options;
+			string format = flagValue(_split, "--format", "legacy");
+			options.format = format == "blocked" ? BLOCK_FORMAT : format == "compact" ? COMPACT_FORMAT : LEGACY_FORMAT;
+			options.threads = static_cast<size_t>(stoull(flagValue(_split, "--threads", to_string(defaultThreads()))));
+			options.packed = hasFlag(_split, "--packed");
+			options.blockSize = static_cast<uint32_t>(stoul(flagValue(_split, "--block-size", to_string(options.packed ? PACKED_BLOCK_SIZE : options.blockSize))));
+			options.direct = hasFlag(_split, "--direct");
+			options.sync = hasFlag(_split, "--fsync");
+
+			if (options.packed && options.format == LEGACY_FORMAT)
+			{
+				cout << "--packed applies to the blocked and compact formats." << endl;
+				continue;
+			}
+
+			string index_file_name = out_file_name + ".idx";
+			if (indexed && !positionIndex.write(index_file_name))
+			{
+				cout << "Error writing file " << index_file_name << "." << endl;
+				continue;
+			}
+
+			bool written = builder.build([&](const BookConfig& config, const shared_ptr<Book>& book)
+			{
+				if (!book->write_book(config.path, options))
+				{
+					cout << "Error writing file " << config.path << "." << endl;
+					return false;
+				}
+
+				if (config.path == out_file_name)
+				{
+					if (indexed)
+					{
+						book->openIndex(index_file_name);
+					}
+
+					live.publish(book);
+				}
+
+				return true;
+			});
+
+			if (!written)
+			{
+				continue;
+			}
+
+			cout << "Successfully written the book 📝" << endl;
+
+		}
+		else if (compareCaseInsensitive(_split[0], "convert"))
+		{
+			if (_split.size() < 3)
+			{
+				cout << "Usage: convert <pgn_file_name> <out_file_name> [--keep-duplicates] [<filters>] [--fsync]" << endl;
+				continue;
+			}
+
+			GameFilter filter;
+			if (!parseFilter(_split, filter))
+			{
+				cout << "Invalid game filter." << endl;
+				continue;
+			}
+
+			ifstream pgn_file(_split[1]);
 			if (!pgn_file.is_open())
 			{
-				cout << "Error opening file " << pgn_file_name << "." << endl;
+				cout << "Error opening file " << _split[1] << "." << endl;
 				continue;
 			}
 
@@ -60,42 +510,145 @@ void start_cli()
 			stream << pgn_file.rdbuf();
 
 			string raw_pgns = stream.str();
-			vector<string> pgns = splitPgns(raw_pgns);
+			vector<PgnGame> games = splitGames(raw_pgns);
+
+			bool dedup = !hasFlag(_split, "--keep-duplicates");
+			FingerprintSet seen(dedup ? games.size() : 0);
+
+			GameArchiveWriter archive;
+			bool ok = archive.open(_split[2]);
+			ParseErrorCounts skipped;
+			size_t setUp = 0;
+
+			for (size_t i = 0; ok && i < games.size(); i++)
+			{
+				const PgnGame& game = games[i];
+
+				if (!filter.accepts(game) || (dedup && !seen.insert(gameFingerprint(game))))
+				{
+					continue;
+				}
+
+				Pgn _pgn{ game };
 
-			for (const auto& pgn : pgns)
+				if (!_pgn.ok())
+				{
+					skipped.add(_pgn.status());
+					continue;
+				}
+
+				// Archives hold moves only, so they cannot carry a start position
+				if (_pgn.fromSetUp())
+				{
+					setUp++;
+					continue;
+				}
+
+				ok = archive.add(game, _pgn);
+			}
+
+			if (!archive.close(hasFlag(_split, "--fsync")) || !ok)
 			{
-				Pgn _pgn(pgn);
-				book.insertFromPgn(_pgn);
+				cout << "Error writing file " << _split[2] << "." << endl;
+				continue;
 			}
 
-			book.write_book(out_file);
+			cout << "Converted " << archive.gameCount() << " of " << games.size() << " games 🗃️" << endl;
 
-			out_file.close();
-			pgn_file.close();
+			if (skipped.total() > 0)
+			{
+				cout << "Skipped " << skipped.total() << " games that failed to parse (" << skipped.summary() << ")." << endl;
+			}
 
-			cout << "Successfully written the book 📝" << endl;
+			if (setUp > 0)
+			{
+				cout << "Skipped " << setUp << " games from a set-up position." << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "merge-shards"))
+		{
+			if (_split.size() < 3)
+			{
+				cout << "Usage: merge-shards <out_file_name> <shard_file_name> [<shard_file_name> ...] [--block-size <bytes>] [--packed] [--direct] [--fsync]" << endl;
+				continue;
+			}
+
+			vector<string> shardFiles;
+			for (size_t i = 2; i < _split.size() && _split[i].rfind("--", 0) != 0; i++)
+			{
+				shardFiles.push_back(_split[i]);
+			}
 
+			BookWriteOptions options;
+			options.blockSize = static_cast<uint32_t>(stoul(flagValue(_split, "--block-size", "0")));
+			options.direct = hasFlag(_split, "--direct");
+			options.sync = hasFlag(_split, "--fsync");
+			options.packed = hasFlag(_split, "--packed");
+
+			if (!mergeBlockBooks(shardFiles, _split[1], options))
+			{
+				cout << "Error merging into " << _split[1] << ", shards must be readable blocked or compact books of the same configuration." << endl;
+				continue;
+			}
+
+			cout << "Merged " << shardFiles.size() << " shards into " << _split[1] << " 📝" << endl;
 		}
 		else if (compareCaseInsensitive(_split[0], "load"))
 		{
 			if (_split.size() < 2)
 			{
-				cout << "Usage: load <file_name>" << endl;
+				cout << "Usage: load <file_name> [--threads <n>] [--paged [--cache <blocks>]] [--huge-pages transparent|explicit] [--prefault] [--mlock] [--warm]" << endl;
 				continue;
 			}
 
 			string inp_file_name = _split[1];
-			ifstream inp_file(inp_file_name);
-			if (!inp_file.is_open())
+			BookLoadOptions options = parseLoadOptions(_split);
+
+			// The learner would lay its counts over, and compact into, the book it opened
+			learner.close();
+
+			if (!live.load(inp_file_name, options))
 			{
 				cout << "Error opening file " << inp_file_name << "." << endl;
 				continue;
 			}
 
-			book.read_book(inp_file);
+			layers.clear();
+
+			if (options.lock && !live.acquire()->isLocked())
+			{
+				cout << "Could not lock the book in memory, check the memlock limit (ulimit -l)." << endl;
+			}
+
 			cout << "Book loaded successfully 📖" << endl;
 
 		}
+		else if (compareCaseInsensitive(_split[0], "reload"))
+		{
+			if (_split.size() < 2)
+			{
+				cout << "Usage: reload <file_name> [--threads <n>] [--paged [--cache <blocks>]] [--huge-pages transparent|explicit] [--prefault] [--mlock] [--warm]" << endl;
+				continue;
+			}
+
+			string inp_file_name = _split[1];
+
+			// As for load, the learner would compact its own book back over this one
+			learner.close();
+
+			bool started = live.reloadAsync(inp_file_name, parseLoadOptions(_split), [inp_file_name](bool ok)
+			{
+				cout << (ok ? "Reloaded " + inp_file_name + " 📖" : "Error reloading file " + inp_file_name + ".") << endl;
+			});
+
+			if (!started)
+			{
+				cout << "A reload is already in progress." << endl;
+				continue;
+			}
+
+			cout << "Reloading " << inp_file_name << " in the background, probes keep using the current book." << endl;
+		}
 		else if (compareCaseInsensitive(_split[0], "getm"))
 		{
 			if (_split.size() < 2)
@@ -105,9 +658,14 @@ void start_cli()
 			}
 
 			string fen = trim(input.substr(5));
-			Board& board = Board::fromFen(fen);
+			Board board;
+			if (!parseProbeFen(fen, board))
+			{
+				continue;
+			}
 
-			Move move = book.getRandMove(board);
+			Move move = learner.isOpen() ? learner.getRandMove(board)
+				: layers.isEmpty() ? live.acquire()->getRandMove(board) : layers.getRandMove(board);
 			if (move.isNull()) 
 			{
 				cout << "Cannot find move :(" << endl;
@@ -129,9 +687,13 @@ void start_cli()
 			string fen = trim(input.substr(6 + _split[1].size()));
 
 			Board board;
-			board.fromFen(fen);
+			if (!parseProbeFen(fen, board))
+			{
+				continue;
+			}
 
-			Move move = book.getRankedMove(board, rank);
+			Move move = learner.isOpen() ? learner.getRankedMove(board, rank)
+				: layers.isEmpty() ? live.acquire()->getRankedMove(board, rank) : layers.getRankedMove(board, rank);
 			if (move.isNull())
 			{
 				cout << "Cannot find move :(" << endl;
@@ -140,12 +702,563 @@ void start_cli()
 
 			cout << move.toUci() << endl;
 		}
+		else if (compareCaseInsensitive(_split[0], "layer"))
+		{
+			string action = _split.size() > 1 ? _split[1] : "";
+
+			if (action == "add" && _split.size() >= 4)
+			{
+				shared_ptr<Book> layerBook = make_shared<Book>(0, 0);
+
+				if (!layerBook->load(_split[2], parseLoadOptions(_split)))
+				{
+					cout << "Error opening file " << _split[2] << "." << endl;
+					continue;
+				}
+
+				double weight = _split.size() > 4 && _split[4].rfind("--", 0) != 0 ? stod(_split[4]) : 1.0;
+				layers.addLayer({ _split[2], layerBook, stoi(_split[3]), weight });
+
+				cout << "Layer added, " << layers.getLayers().size() << " layers loaded 📚" << endl;
+			}
+			else if (action == "mode" && _split.size() >= 3)
+			{
+				layers.setMode(_split[2] == "blend" ? BLEND : FIRST_HIT);
+			}
+			else if (action == "list")
+			{
+				for (const auto& layer : layers.getLayers())
+				{
+					cout << layer.name << " priority=" << layer.priority << " weight=" << layer.weight << endl;
+				}
+			}
+			else if (action == "clear")
+			{
+				layers.clear();
+			}
+			else
+			{
+				cout << "Usage: layer add <file_name> <priority> [<weight>] [--paged [--cache <blocks>]]" << endl;
+				cout << "Usage: layer mode <first|blend> | layer list | layer clear" << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "games"))
+		{
+			size_t bar = input.find('|');
+			string fen = trim(input.substr(6, bar == string::npos ? string::npos : bar - 6));
+
+			if (_split.size() < 2 || fen.empty())
+			{
+				cout << "Usage: games <FEN> [| <FEN>]" << endl;
+				continue;
+			}
+
+			shared_ptr<Book> book = live.acquire();
+			const PositionIndex* index = book->gameIndex();
+
+			if (!index)
+			{
+				cout << "No position index loaded, build the book with make --index." << endl;
+				continue;
+			}
+
+			Board board, second;
+			if (!readFen(fen, board) || (bar != string::npos && !readFen(trim(input.substr(bar + 1)), second)))
+			{
+				continue;
+			}
+
+			vector<uint32_t> games;
+			index->find(board, games);
+
+			if (bar != string::npos)
+			{
+				vector<uint32_t> other;
+				index->find(second, other);
+				games = intersectGames(games, other);
+			}
+
+			cout << games.size() << " games:";
+
+			for (size_t i = 0; i < min<size_t>(games.size(), 50); i++)
+			{
+				cout << " " << games[i];
+			}
+
+			cout << (games.size() > 50 ? " ..." : "") << endl;
+		}
+		else if (compareCaseInsensitive(_split[0], "children"))
+		{
+			auto movesAt = find(_split.begin(), _split.end(), "moves");
+
+			if (_split.size() < 4 || movesAt == _split.end())
+			{
+				cout << "Usage: children <FEN> moves <uci_move> [<uci_move> ...]" << endl;
+				continue;
+			}
+
+			string fen;
+			for (auto it = _split.begin() + 1; it != movesAt; ++it)
+			{
+				fen += (fen.empty() ? "" : " ") + *it;
+			}
+
+			vector<Move> candidates;
+			bool validMoves = true;
+
+			for (auto it = movesAt + 1; it != _split.end(); ++it)
+			{
+				candidates.emplace_back();
+				validMoves = readMove(*it, candidates.back()) && validMoves;
+			}
+
+			Board board;
+			if (!validMoves || !readFen(fen, board))
+			{
+				continue;
+			}
+
+			shared_ptr<Book> book = live.acquire();
+			vector<ChildHit> hits = book->probeChildren(board, candidates);
+
+			if (hits.empty())
+			{
+				cout << "Cannot find move :(" << endl;
+				continue;
+			}
+
+			for (const auto& hit : hits)
+			{
+				cout << hit.move.toUci() << ":";
+
+				for (const auto& entry : *hit.entries)
+				{
+					cout << " " << entry.move.toUci() << "(" << entry.count << ")";
+				}
+
+				cout << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "verify"))
+		{
+			if (_split.size() < 2)
+			{
+				cout << "Usage: verify <file_name> [--threads <n>]" << endl;
+				continue;
+			}
+
+			BlockBookReader reader;
+			if (!reader.open(_split[1], 0))
+			{
+				cout << "Error opening file " << _split[1] << ", not a block book or its index is damaged." << endl;
+				continue;
+			}
+
+			if (!reader.hasChecksums())
+			{
+				cout << _split[1] << " predates block checksums, rewrite it with make --format blocked." << endl;
+				continue;
+			}
+
+			size_t threads = static_cast<size_t>(stoull(flagValue(_split, "--threads", to_string(defaultThreads()))));
+			vector<size_t> corrupt = reader.verify(threads);
+
+			cout << "Checked " << reader.blockCount() << " blocks (" << (crc32cHardware() ? "hardware" : "software")
+				<< " CRC32C): " << corrupt.size() << " corrupt." << endl;
+
+			for (size_t i = 0; i < min<size_t>(corrupt.size(), 10); i++)
+			{
+				cout << "block " << corrupt[i] << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "latency"))
+		{
+			string action = _split.size() > 1 ? _split[1] : "";
+
+			if (action == "on" || action == "off")
+			{
+				ProbeTelemetry::setEnabled(action == "on");
+				continue;
+			}
+
+			if (action == "reset")
+			{
+				ProbeTelemetry::reset();
+				continue;
+			}
+
+			vector<PhaseSummary> summaries = ProbeTelemetry::summarize();
+
+			if (action == "--json")
+			{
+				cout << ProbeTelemetry::toJson(summaries) << endl;
+				continue;
+			}
+
+			cout << "phase     count      p50(ns)    p99(ns)    p999(ns)   max(ns)    hit ratio" << endl;
+
+			for (const auto& summary : summaries)
+			{
+				uint64_t counted = summary.hits + summary.misses;
+
+				cout << left << setw(10) << phaseName(summary.phase) << setw(11) << summary.count
+					<< setw(11) << summary.p50 << setw(11) << summary.p99 << setw(11) << summary.p999
+					<< setw(11) << summary.max << right;
+
+				if (counted > 0)
+				{
+					cout << fixed << setprecision(3) << static_cast<double>(summary.hits) / counted << defaultfloat;
+				}
+				else
+				{
+					cout << "-";
+				}
+
+				cout << endl;
+			}
+
+			cout << "Telemetry is " << (ProbeTelemetry::isEnabled() ? "on" : "off") << "." << endl;
+		}
+		else if (compareCaseInsensitive(_split[0], "learn"))
+		{
+			string action = _split.size() > 1 ? _split[1] : "";
+
+			if (action == "open" && _split.size() >= 3)
+			{
+				unsigned interval = static_cast<unsigned>(stoul(flagValue(_split, "--interval", "60")));
+
+				if (!learner.open(_split[2], parseLoadOptions(_split), interval))
+				{
+					cout << "Error opening " << _split[2] << ", learning needs a blocked or compact book." << endl;
+					continue;
+				}
+
+				layers.clear();
+				cout << "Learning into " << _split[2] << ", " << learner.pending() << " updates pending from the log 🧠" << endl;
+			}
+			else if (action == "add" && _split.size() >= 5)
+			{
+				GameResult result = parseResult(_split[3]);
+				string fen = trim(input.substr(input.find(_split[3], input.find(_split[2]) + _split[2].size()) + _split[3].size()));
+
+				Board board;
+				Move move;
+				if (!readMove(_split[2], move) || !readFen(fen, board))
+				{
+					continue;
+				}
+
+				if (!learner.record(board, move, result))
+				{
+					cout << "Error recording the update, is a book open for learning?" << endl;
+				}
+			}
+			else if (action == "game" && _split.size() >= 4)
+			{
+				GameResult result = parseResult(_split[2]);
+				string movetext = trim(input.substr(input.find(_split[2], input.find("game") + 4) + _split[2].size()));
+
+				Pgn _pgn{ movetext };
+
+				if (!_pgn.ok())
+				{
+					cout << "Error at ply " << _pgn.moveCount() + 1 << ": " << parseErrorName(_pgn.status()) << "." << endl;
+					continue;
+				}
+
+				cout << "Recorded " << learner.recordGame(_pgn, result) << " moves." << endl;
+			}
+			else if (action == "compact")
+			{
+				cout << (learner.compact() ? "Compacted the learned counts into the book 📝" : "Error compacting the book.") << endl;
+			}
+			else if (action == "status")
+			{
+				cout << (learner.isOpen() ? "open" : "closed") << ", " << learner.recorded() << " updates recorded, "
+					<< learner.pending() << " pending compaction." << endl;
+			}
+			else if (action == "close")
+			{
+				learner.close();
+			}
+			else
+			{
+				cout << "Usage: learn open <file_name> [--interval <seconds>] [--threads <n>] [--paged [--cache <blocks>]]" << endl;
+				cout << "Usage: learn add <uci_move> <1-0|0-1|1/2-1/2> <FEN> | learn game <result> <san_movetext>" << endl;
+				cout << "Usage: learn compact | learn status | learn close" << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "audit"))
+		{
+			if (_split.size() < 3)
+			{
+				cout << "Usage: audit <pgn_file_name> <moves>" << endl;
+				continue;
+			}
+
+			ifstream pgn_file(_split[1]);
+			if (!pgn_file.is_open())
+			{
+				cout << "Error opening file " << _split[1] << "." << endl;
+				continue;
+			}
+
+			stringstream stream;
+			stream << pgn_file.rdbuf();
+
+			string raw_pgns = stream.str();
+			KeyAuditReport report = auditKeys(splitGames(raw_pgns), static_cast<size_t>(stoull(_split[2])));
+
+			cout << "Audited " << report.positions << " positions from " << report.games << " games: "
+				<< report.collisions.size() << " key collisions." << endl;
+
+			if (report.skipped.total() > 0)
+			{
+				cout << "Skipped " << report.skipped.total() << " games that failed to parse (" << report.skipped.summary() << ")." << endl;
+			}
+
+			for (size_t i = 0; i < min<size_t>(report.collisions.size(), 10); i++)
+			{
+				const KeyCollision& collision = report.collisions[i];
+				cout << hex << collision.key << dec << ": " << collision.first << " | " << collision.second << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "preview"))
+		{
+			if (_split.size() < 4)
+			{
+				cout << "Usage: preview <pgn_file_name> <variations> <moves> [--sample <games>] [--seed <n>] [--keep-duplicates] [<filters>] [--format legacy|blocked|compact] [--block-size <bytes>]" << endl;
+				continue;
+			}
+
+			GameFilter filter;
+			if (!parseFilter(_split, filter))
+			{
+				cout << "Invalid game filter." << endl;
+				continue;
+			}
+
+			PreviewOptions options;
+			options.variations = static_cast<size_t>(stoull(_split[2]));
+			options.moves = static_cast<size_t>(stoull(_split[3]));
+
+			string format = flagValue(_split, "--format", "legacy");
+			options.format = format == "blocked" ? BLOCK_FORMAT : format == "compact" ? COMPACT_FORMAT : LEGACY_FORMAT;
+			options.blockSize = static_cast<uint32_t>(stoul(flagValue(_split, "--block-size", to_string(BookWriteOptions().blockSize))));
+
+			size_t capacity = static_cast<size_t>(stoull(flagValue(_split, "--sample", "10000")));
+			uint64_t seed = hasFlag(_split, "--seed") ? stoull(flagValue(_split, "--seed", "0")) : random_device{}();
+			ReservoirSampler sampler(capacity, seed);
+
+			GameArchiveReader archive;
+			PreviewReport report;
+			size_t filtered = 0;
+			size_t duplicates = 0;
+
+			if (archive.open(_split[1]))
+			{
+				if (filter.needsTags())
+				{
+					cout << "Game archives only keep Elo and result, apply other filters at convert time." << endl;
+					continue;
+				}
+
+				vector<ArchivedGame> sample;
+
+				for (const auto& game : archive.games())
+				{
+					size_t slot;
+
+					if (!filter.accepts(game))
+					{
+						filtered++;
+					}
+					else if (sampler.admit(slot))
+					{
+						if (slot == sample.size())
+						{
+							sample.push_back(game);
+						}
+						else
+						{
+							sample[slot] = game;
+						}
+					}
+				}
+
+				report = previewBook(sample, sampler.offered(), options);
+			}
+			else
+			{
+				// Only the sample is kept, the file streams through a chunk at a time
+				PgnChunkReader reader;
+
+				if (!reader.open(_split[1]))
+				{
+					cout << "Error opening file " << _split[1] << "." << endl;
+					continue;
+				}
+
+				bool dedup = !hasFlag(_split, "--keep-duplicates");
+				FingerprintSet seen;
+				vector<SampledGame> sample;
+				string chunk;
+
+				while (reader.next(chunk))
+				{
+					for (const auto& game : splitGames(chunk))
+					{
+						size_t slot;
+
+						if (!filter.accepts(game))
+						{
+							filtered++;
+						}
+						else if (dedup && !seen.insert(gameFingerprint(game)))
+						{
+							duplicates++;
+						}
+						else if (sampler.admit(slot))
+						{
+							if (slot == sample.size())
+							{
+								sample.emplace_back();
+							}
+
+							sample[slot].tags.assign(game.tags);
+							sample[slot].movetext.assign(game.movetext);
+						}
+					}
+				}
+
+				vector<PgnGame> games;
+
+				for (const auto& game : sample)
+				{
+					games.push_back(game.view());
+				}
+
+				report = previewBook(games, sampler.offered(), options);
+			}
+
+			if (filter.isActive())
+			{
+				cout << "Filtered out " << filtered << " games." << endl;
+			}
+
+			if (duplicates > 0)
+			{
+				cout << "Skipped " << duplicates << " duplicate games." << endl;
+			}
+
+			if (report.skipped.total() > 0)
+			{
+				cout << "Skipped " << report.skipped.total() << " sampled games that failed to parse (" << report.skipped.summary() << ")." << endl;
+			}
+
+			cout << "Sampled " << report.games << " of " << report.corpus << " games." << endl;
+			cout << "depth  positions  estimated  est. size(KB)  coverage" << endl;
+
+			for (const auto& depth : report.depths)
+			{
+				cout << left << setw(7) << depth.depth << setw(11) << depth.positions
+					<< setw(11) << static_cast<uint64_t>(depth.estimatedPositions)
+					<< setw(15) << static_cast<uint64_t>(depth.estimatedBytes / 1024) << right
+					<< fixed << setprecision(3) << depth.coverage << defaultfloat << endl;
+			}
+		}
+		else if (compareCaseInsensitive(_split[0], "graph"))
+		{
+			// Everything but the flags and their values is the list of extra roots
+			string fens;
+
+			for (size_t i = 1; i < _split.size(); i++)
+			{
+				if (_split[i] == "--depth" || _split[i] == "--threads")
+				{
+					i++;
+					continue;
+				}
+
+				fens += (fens.empty() ? "" : " ") + _split[i];
+			}
+
+			vector<GraphRoot> roots = { { Board(), 0 } };
+			bool validRoots = true;
+
+			for (const auto& fen : split(fens, "|"))
+			{
+				if (!trim(fen).empty())
+				{
+					roots.push_back({ Board(), 0 });
+					validRoots = readFen(trim(fen), roots.back().board) && validRoots;
+					roots.back().ply = fenPly(trim(fen), roots.back().board);
+				}
+			}
+
+			if (!validRoots)
+			{
+				cout << "Usage: graph [<FEN> [| <FEN> ...]] [--depth <plies>] [--threads <n>]" << endl;
+				continue;
+			}
+
+			GraphOptions options;
+			options.depth = static_cast<size_t>(stoull(flagValue(_split, "--depth", to_string(SIZE_MAX))));
+			options.threads = static_cast<size_t>(stoull(flagValue(_split, "--threads", to_string(defaultThreads()))));
+
+			shared_ptr<Book> book = live.acquire();
+			GraphReport report = traverseBook(*book, roots, options);
+
+			for (const auto& fen : report.missingRoots)
+			{
+				cout << "Not in book: " << fen << endl;
+			}
+
+			cout << "Reached " << report.positions << " positions through " << report.moves << " stored moves: "
+				<< report.exits << " exits at the book's depth, " << report.deadEnds << " dead ends, "
+				<< report.transpositions << " transpositions, " << report.broken << " unplayable moves." << endl;
+
+			cout << "ply    positions  moves      branching  lines          exits      dead ends" << endl;
+
+			for (const auto& stats : report.depths)
+			{
+				cout << left << setw(7) << stats.ply << setw(11) << stats.positions << setw(11) << stats.moves
+					<< setw(11) << fixed << setprecision(2) << static_cast<double>(stats.moves) / stats.positions << defaultfloat
+					<< setw(15) << setprecision(6) << stats.lines << setw(11) << stats.exits << stats.deadEnds << right << endl;
+			}
+
+			for (const auto& sample : report.deadEndSamples)
+			{
+				cout << "Dead end: " << sample << endl;
+			}
+
+			for (const auto& sample : report.brokenSamples)
+			{
+				cout << "Unplayable: " << sample << endl;
+			}
+		}
 		else if (compareCaseInsensitive(_split[0], "help")) 
 		{
-			cout << "Usage: make <pgn_file_name> <out_file_name>" << endl;
-			cout << "Usage: load <file_name>" << endl;
+			cout << "Usage: make <pgn_file_name> <out_file_name> <variations> <moves> [--config <out_file_name>,<variations>,<moves> ...] [--bounded] [--keep-duplicates] [<filters>] [--format legacy|blocked|compact] [--packed] [--block-size <bytes>] [--threads <n>] [--direct] [--fsync] [--index] [--shard <i>/<n>] [--cache <dir>]" << endl;
+			cout << "Filters: --elo|--white-elo|--black-elo <lo-hi> --time-control <bullet|blitz|rapid|classical|tc,...>" << endl;
+			cout << "         --result <decisive|1-0,0-1,...> --event <text> --date <YYYY.MM.DD-YYYY.MM.DD>" << endl;
+			cout << "Usage: convert <pgn_file_name> <out_file_name> [--keep-duplicates] [<filters>] [--fsync] (make also accepts the archive)" << endl;
+			cout << "Usage: merge-shards <out_file_name> <shard_file_name> [<shard_file_name> ...] [--block-size <bytes>] [--packed] [--direct] [--fsync]" << endl;
+			cout << "Usage: load <file_name> [--threads <n>] [--paged [--cache <blocks>]] [--huge-pages transparent|explicit] [--prefault] [--mlock] [--warm]" << endl;
+			cout << "Usage: reload <file_name> [--threads <n>] [--paged [--cache <blocks>]] [--huge-pages transparent|explicit] [--prefault] [--mlock] [--warm] (swaps the book in without blocking probes)" << endl;
 			cout << "Usage: getrm <rank> <FEN>" << endl;
 			cout << "Usage: getm <FEN>" << endl;
+			cout << "Usage: layer add <file_name> <priority> [<weight>] [--paged [--cache <blocks>]]" << endl;
+			cout << "Usage: layer mode <first|blend> | layer list | layer clear (getm/getrm probe the layers once any are added)" << endl;
+			cout << "Usage: games <FEN> [| <FEN>] (games that reached the position, or both positions, per make --index)" << endl;
+			cout << "Usage: children <FEN> moves <uci_move> [<uci_move> ...]" << endl;
+			cout << "Usage: graph [<FEN> [| <FEN> ...]] [--depth <plies>] [--threads <n>] (walks the loaded book from the start position and the given roots, each from the ply of its move number)" << endl;
+			cout << "Usage: verify <file_name> [--threads <n>] (checks the block checksums of a blocked or compact book)" << endl;
+			cout << "Usage: latency [--json] | latency on|off|reset (per-phase probe latency and hit ratios)" << endl;
+			cout << "Usage: learn open <file_name> [--interval <seconds>] [--threads <n>] [--paged [--cache <blocks>]]" << endl;
+			cout << "Usage: learn add <uci_move> <1-0|0-1|1/2-1/2> <FEN> | learn game <result> <san_movetext> | learn compact|status|close (getm/getrm count pending updates while learning)" << endl;
+			cout << "Usage: audit <pgn_file_name> <moves>" << endl;
+			cout << "Usage: preview <pgn_file_name> <variations> <moves> [--sample <games>] [--seed <n>] [--keep-duplicates] [<filters>] [--format legacy|blocked|compact] [--block-size <bytes>] (estimates per depth from a uniform sample)" << endl;
 			cout << "Usage: quit (quit's the command line interface)" << endl;
 
 		}
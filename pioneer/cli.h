@@ -2,14 +2,29 @@
 
 #include "utils/split.h"
 #include "utils/trim.h"
+#include "utils/fingerprint_set.h"
 #include "split_pgns.h"
+#include "game_filter.h"
+#include "block_book.h"
+#include "key_audit.h"
+#include "book_graph.h"
+#include "layered_book.h"
+#include "live_book.h"
+#include "game_archive.h"
+#include "multi_build.h"
+#include "chunk_cache.h"
+#include "learner.h"
+#include "preview.h"
 #include "book.h"
 #include "pgn.h"
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <random>
 #include <vector>
 
 void start_cli();
@@ -0,0 +1,189 @@
+#include <charconv>
+#include <algorithm>
+#include "game_archive.h"
+#include "game_filter.h"
+
+using namespace std;
+
+Move ArchivedGame::getMove(size_t index) const
+{
+    int16_t encoded;
+    memcpy(&encoded, moves + index * sizeof(encoded), sizeof(encoded));
+    return Move::decode(encoded);
+}
+
+bool isGameArchive(const char* data, size_t size)
+{
+    return size >= sizeof(ArchiveHeader) && memcmp(data, GAME_ARCHIVE_MAGIC, sizeof(GAME_ARCHIVE_MAGIC)) == 0;
+}
+
+GameResult parseResult(string_view result)
+{
+    if (result == "1-0") return WHITE_WINS;
+    if (result == "0-1") return BLACK_WINS;
+    if (result == "1/2-1/2") return DRAWN;
+    return UNKNOWN_RESULT;
+}
+
+string_view resultString(GameResult result)
+{
+    switch (result)
+    {
+    case WHITE_WINS: return "1-0";
+    case BLACK_WINS: return "0-1";
+    case DRAWN: return "1/2-1/2";
+    default: return "*";
+    }
+}
+
+static uint16_t parseElo(string_view elo)
+{
+    unsigned value = 0;
+    auto parsed = from_chars(elo.data(), elo.data() + elo.size(), value);
+
+    if (parsed.ec != errc() || parsed.ptr != elo.data() + elo.size())
+    {
+        return 0;
+    }
+
+    return static_cast<uint16_t>(min<unsigned>(value, UINT16_MAX));
+}
+
+GameArchiveWriter::GameArchiveWriter() : games(0), plies(0) {}
+
+bool GameArchiveWriter::open(const string& path)
+{
+    games = 0;
+    plies = 0;
+    buffer.clear();
+    buffer.reserve(BUFFER_SIZE);
+
+    ArchiveHeader header = {};
+    memcpy(header.magic, GAME_ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = GAME_ARCHIVE_VERSION;
+
+    return file.open(path, false) && file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool GameArchiveWriter::flush()
+{
+    bool ok = file.write(buffer.data(), buffer.size());
+    buffer.clear();
+    return ok;
+}
+
+// Games longer than the u16 ply field are cut; no book goes that deep.
+bool GameArchiveWriter::add(const PgnGame& game, const Pgn& pgn)
+{
+    GameTags tags = scanTags(game.tags);
+
+    ArchiveGameHeader header = {};
+    header.plies = static_cast<uint16_t>(min<size_t>(pgn.moveCount(), UINT16_MAX));
+    header.result = parseResult(tags.result);
+    header.whiteElo = parseElo(tags.whiteElo);
+    header.blackElo = parseElo(tags.blackElo);
+
+    const char* raw = reinterpret_cast<const char*>(&header);
+    buffer.insert(buffer.end(), raw, raw + sizeof(header));
+
+    for (size_t i = 0; i < header.plies; i++)
+    {
+        int16_t encoded = pgn.getMove(i).encode();
+        raw = reinterpret_cast<const char*>(&encoded);
+        buffer.insert(buffer.end(), raw, raw + sizeof(encoded));
+    }
+
+    games++;
+    plies += header.plies;
+
+    return buffer.size() < BUFFER_SIZE || flush();
+}
+
+bool GameArchiveWriter::close(bool sync)
+{
+    ArchiveFooter footer = {};
+    footer.gameCount = games;
+    footer.plyCount = plies;
+    memcpy(footer.magic, GAME_ARCHIVE_MAGIC, sizeof(footer.magic));
+
+    bool ok = flush() && file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    return file.close(sync) && ok;
+}
+
+uint64_t GameArchiveWriter::gameCount() const
+{
+    return games;
+}
+
+GameArchiveReader::GameArchiveReader() : plyCount(0) {}
+
+// Builds the game index in one sequential pass over the mapping; the move
+// arrays themselves are only touched when a game is replayed.
+bool GameArchiveReader::open(const string& path)
+{
+    index.clear();
+
+    if (!file.open(path) || !isGameArchive(file.data(), file.size())
+        || file.size() < sizeof(ArchiveHeader) + sizeof(ArchiveFooter))
+    {
+        return false;
+    }
+
+    ArchiveHeader header;
+    ArchiveFooter footer;
+    memcpy(&header, file.data(), sizeof(header));
+    memcpy(&footer, file.data() + file.size() - sizeof(footer), sizeof(footer));
+
+    if (header.version != GAME_ARCHIVE_VERSION || memcmp(footer.magic, GAME_ARCHIVE_MAGIC, sizeof(footer.magic)) != 0)
+    {
+        return false;
+    }
+
+    // Every game takes at least its header, so a larger count cannot be honest
+    size_t body = file.size() - sizeof(ArchiveHeader) - sizeof(ArchiveFooter);
+
+    if (footer.gameCount > body / sizeof(ArchiveGameHeader))
+    {
+        return false;
+    }
+
+    file.adviseSequential();
+    index.reserve(footer.gameCount);
+    plyCount = footer.plyCount;
+
+    const char* in = file.data() + sizeof(ArchiveHeader);
+    const char* end = file.data() + file.size() - sizeof(ArchiveFooter);
+
+    while (in < end)
+    {
+        ArchiveGameHeader game;
+
+        if (static_cast<size_t>(end - in) < sizeof(game))
+        {
+            return false;
+        }
+
+        memcpy(&game, in, sizeof(game));
+        in += sizeof(game);
+
+        if (static_cast<size_t>(end - in) < game.plies * sizeof(int16_t))
+        {
+            return false;
+        }
+
+        index.push_back({ static_cast<GameResult>(game.result), game.whiteElo, game.blackElo, game.plies, in });
+        in += game.plies * sizeof(int16_t);
+    }
+
+    return index.size() == footer.gameCount;
+}
+
+const vector<ArchivedGame>& GameArchiveReader::games() const
+{
+    return index;
+}
+
+uint64_t GameArchiveReader::plies() const
+{
+    return plyCount;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/mapped_file.h"
+#include "utils/file_io.h"
+#include "split_pgns.h"
+#include "board.h"
+#include "pgn.h"
+
+using namespace std;
+
+// Game archive layout: header, games, footer. SAN is resolved once by the
+// convert command; make replays the stored moves without touching text.
+//
+//   game := plies u16 | result u8 | reserved u8 | whiteElo u16 | blackElo u16 | plies * move i16
+//
+// Moves are Move::encode() values. An Elo of 0 means the tag was missing.
+
+constexpr char GAME_ARCHIVE_MAGIC[4] = { 'P', 'N', 'G', 'A' };
+constexpr uint16_t GAME_ARCHIVE_VERSION = 1;
+
+enum GameResult : uint8_t
+{
+    UNKNOWN_RESULT,
+    WHITE_WINS,
+    BLACK_WINS,
+    DRAWN
+};
+
+struct ArchiveHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint64_t reserved;
+};
+
+struct ArchiveGameHeader
+{
+    uint16_t plies;
+    uint8_t result;
+    uint8_t reserved;
+    uint16_t whiteElo;
+    uint16_t blackElo;
+};
+
+struct ArchiveFooter
+{
+    uint64_t gameCount;
+    uint64_t plyCount;
+    char magic[4];
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ArchiveHeader) == 16, "ArchiveHeader must be packed");
+static_assert(sizeof(ArchiveGameHeader) == 8, "ArchiveGameHeader must be packed");
+static_assert(sizeof(ArchiveFooter) == 24, "ArchiveFooter must be packed");
+
+// View of one game inside a mapped archive
+struct ArchivedGame
+{
+    GameResult result;
+    uint16_t whiteElo;
+    uint16_t blackElo;
+    uint16_t plies;
+    const char* moves;
+
+    Move getMove(size_t index) const;
+
+    // Set-up games are not archived, so every game starts from the initial position
+    Board startPosition() const { return Board(); }
+};
+
+bool isGameArchive(const char* data, size_t size);
+GameResult parseResult(string_view result);
+string_view resultString(GameResult result);
+
+class GameArchiveWriter
+{
+private:
+    OutputFile file;
+    vector<char> buffer;
+    uint64_t games;
+    uint64_t plies;
+
+    bool flush();
+
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    GameArchiveWriter();
+
+    bool open(const string& path);
+    bool add(const PgnGame& game, const Pgn& pgn);
+    bool close(bool sync);
+    uint64_t gameCount() const;
+};
+
+class GameArchiveReader
+{
+private:
+    MappedFile file;
+    vector<ArchivedGame> index;
+    uint64_t plyCount;
+
+public:
+    GameArchiveReader();
+
+    bool open(const string& path);
+    const vector<ArchivedGame>& games() const;
+    uint64_t plies() const;
+};
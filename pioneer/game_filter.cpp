@@ -0,0 +1,263 @@
+#include <charconv>
+#include <algorithm>
+#include "game_filter.h"
+#include "game_archive.h"
+#include "utils/split.h"
+
+using namespace std;
+
+static bool parseInt(string_view text, int& value)
+{
+	auto result = from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == errc() && result.ptr == text.data() + text.size();
+}
+
+// "lo-hi", "lo-" or "-hi"
+static bool parseRange(const string& range, int& lo, int& hi)
+{
+	size_t dash = range.find('-');
+	if (dash == string::npos)
+	{
+		return false;
+	}
+
+	string_view view(range);
+	string_view from = view.substr(0, dash);
+	string_view to = view.substr(dash + 1);
+
+	lo = INT_MIN;
+	hi = INT_MAX;
+
+	return (from.empty() || parseInt(from, lo)) && (to.empty() || parseInt(to, hi));
+}
+
+GameTags scanTags(string_view tags)
+{
+	GameTags found;
+
+	while (!tags.empty())
+	{
+		size_t eol = tags.find('\n');
+		string_view line = tags.substr(0, eol);
+		tags = eol == string_view::npos ? string_view() : tags.substr(eol + 1);
+
+		size_t space = line.find(' ');
+		size_t open = line.find('"');
+		size_t close = line.rfind('"');
+
+		if (line.empty() || line[0] != '[' || space == string_view::npos || open == close)
+		{
+			continue;
+		}
+
+		string_view name = line.substr(1, space - 1);
+		string_view value = line.substr(open + 1, close - open - 1);
+
+		switch (name[0])
+		{
+		case 'W': if (name == "WhiteElo") found.whiteElo = value; break;
+		case 'B': if (name == "BlackElo") found.blackElo = value; break;
+		case 'T': if (name == "TimeControl") found.timeControl = value; break;
+		case 'R': if (name == "Result") found.result = value; break;
+		case 'E': if (name == "Event") found.event = value; break;
+		case 'D': if (name == "Date") found.date = value; break;
+		case 'F': if (name == "FEN") found.fen = value; break;
+		}
+	}
+
+	return found;
+}
+
+// Lichess-style estimate: base seconds plus 40 moves of increment
+static TimeControlClass classify(string_view timeControl)
+{
+	size_t plus = timeControl.find('+');
+	int base = 0;
+	int increment = 0;
+
+	if (!parseInt(timeControl.substr(0, plus), base)
+		|| (plus != string_view::npos && !parseInt(timeControl.substr(plus + 1), increment)))
+	{
+		return ANY_SPEED;
+	}
+
+	int estimate = base + 40 * increment;
+
+	if (estimate < 180) return BULLET;
+	if (estimate < 480) return BLITZ;
+	if (estimate < 1500) return RAPID;
+	return CLASSICAL;
+}
+
+static bool inRange(string_view elo, int lo, int hi)
+{
+	int value;
+	return parseInt(elo, value) && value >= lo && value <= hi;
+}
+
+GameFilter::GameFilter()
+	: whiteEloMin(INT_MIN), whiteEloMax(INT_MAX), blackEloMin(INT_MIN), blackEloMax(INT_MAX),
+	speed(ANY_SPEED), active(false) {}
+
+bool GameFilter::setWhiteElo(const string& range)
+{
+	active = true;
+	return parseRange(range, whiteEloMin, whiteEloMax);
+}
+
+bool GameFilter::setBlackElo(const string& range)
+{
+	active = true;
+	return parseRange(range, blackEloMin, blackEloMax);
+}
+
+// A speed class (bullet, blitz, rapid, classical) or a comma separated list
+// of exact TimeControl values.
+bool GameFilter::setTimeControl(const string& spec)
+{
+	active = true;
+	speed = ANY_SPEED;
+	timeControls.clear();
+
+	if (spec == "bullet") speed = BULLET;
+	else if (spec == "blitz") speed = BLITZ;
+	else if (spec == "rapid") speed = RAPID;
+	else if (spec == "classical") speed = CLASSICAL;
+	else timeControls = split(spec, ",");
+
+	return !spec.empty();
+}
+
+// "decisive" or a comma separated list of results
+bool GameFilter::setResult(const string& spec)
+{
+	active = true;
+	results = spec == "decisive" ? vector<string>{ "1-0", "0-1" } : split(spec, ",");
+
+	for (const auto& result : results)
+	{
+		if (result != "1-0" && result != "0-1" && result != "1/2-1/2" && result != "*")
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void GameFilter::setEvent(const string& substring)
+{
+	active = true;
+	event = substring;
+}
+
+// "YYYY.MM.DD-YYYY.MM.DD", either end may be left open. PGN dates compare
+// correctly as strings.
+bool GameFilter::setDate(const string& range)
+{
+	size_t dash = range.find('-');
+	if (dash == string::npos)
+	{
+		return false;
+	}
+
+	active = true;
+	dateFrom = range.substr(0, dash);
+	dateTo = range.substr(dash + 1);
+	return true;
+}
+
+bool GameFilter::isActive() const
+{
+	return active;
+}
+
+// True if a predicate reads a tag the game archive does not keep
+bool GameFilter::needsTags() const
+{
+	return speed != ANY_SPEED || !timeControls.empty() || !event.empty() || !dateFrom.empty() || !dateTo.empty();
+}
+
+bool GameFilter::accepts(const PgnGame& game) const
+{
+	if (!active)
+	{
+		return true;
+	}
+
+	GameTags tags = scanTags(game.tags);
+
+	if ((whiteEloMin != INT_MIN || whiteEloMax != INT_MAX) && !inRange(tags.whiteElo, whiteEloMin, whiteEloMax))
+	{
+		return false;
+	}
+
+	if ((blackEloMin != INT_MIN || blackEloMax != INT_MAX) && !inRange(tags.blackElo, blackEloMin, blackEloMax))
+	{
+		return false;
+	}
+
+	if (speed != ANY_SPEED && classify(tags.timeControl) != speed)
+	{
+		return false;
+	}
+
+	if (!timeControls.empty() && find(timeControls.begin(), timeControls.end(), tags.timeControl) == timeControls.end())
+	{
+		return false;
+	}
+
+	if (!results.empty() && find(results.begin(), results.end(), tags.result) == results.end())
+	{
+		return false;
+	}
+
+	if (!event.empty() && tags.event.find(event) == string_view::npos)
+	{
+		return false;
+	}
+
+	if (!dateFrom.empty() || !dateTo.empty())
+	{
+		if (tags.date.empty() || tags.date.find('?') != string_view::npos)
+		{
+			return false;
+		}
+
+		if ((!dateFrom.empty() && tags.date < dateFrom) || (!dateTo.empty() && tags.date > dateTo))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Elo and result predicates against the fields kept in a game archive. An
+// Elo of 0 stands for a missing tag and fails any Elo range, as above.
+bool GameFilter::accepts(const ArchivedGame& game) const
+{
+	if (!active)
+	{
+		return true;
+	}
+
+	if ((whiteEloMin != INT_MIN || whiteEloMax != INT_MAX)
+		&& (game.whiteElo == 0 || game.whiteElo < whiteEloMin || game.whiteElo > whiteEloMax))
+	{
+		return false;
+	}
+
+	if ((blackEloMin != INT_MIN || blackEloMax != INT_MAX)
+		&& (game.blackElo == 0 || game.blackElo < blackEloMin || game.blackElo > blackEloMax))
+	{
+		return false;
+	}
+
+	if (!results.empty() && find(results.begin(), results.end(), resultString(game.result)) == results.end())
+	{
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string_view>
+#include <climits>
+#include <string>
+#include <vector>
+#include "split_pgns.h"
+
+using namespace std;
+
+struct ArchivedGame;
+
+struct GameTags
+{
+	string_view whiteElo;
+	string_view blackElo;
+	string_view timeControl;
+	string_view result;
+	string_view event;
+	string_view date;
+	string_view fen;
+};
+
+GameTags scanTags(string_view tags);
+
+enum TimeControlClass
+{
+	ANY_SPEED,
+	BULLET,
+	BLITZ,
+	RAPID,
+	CLASSICAL
+};
+
+// Header predicates evaluated on the raw tag section, so rejected games never
+// reach the movetext tokenizer. A predicate on a missing or unknown ("?")
+// tag rejects the game.
+class GameFilter
+{
+private:
+	int whiteEloMin, whiteEloMax;
+	int blackEloMin, blackEloMax;
+	TimeControlClass speed;
+	vector<string> timeControls;
+	vector<string> results;
+	string event;
+	string dateFrom, dateTo;
+	bool active;
+
+public:
+	GameFilter();
+
+	bool setWhiteElo(const string& range);
+	bool setBlackElo(const string& range);
+	bool setTimeControl(const string& spec);
+	bool setResult(const string& spec);
+	void setEvent(const string& substring);
+	bool setDate(const string& range);
+
+	bool isActive() const;
+	bool needsTags() const;
+	bool accepts(const PgnGame& game) const;
+	bool accepts(const ArchivedGame& game) const;
+};
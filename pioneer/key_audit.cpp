@@ -0,0 +1,69 @@
+#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include "utils/zobrist.h"
+#include "key_audit.h"
+#include "pgn.h"
+
+using namespace std;
+
+typedef array<char, 33> FullKey; // 32-byte board encoding plus side to move
+
+static FullKey fullKey(const Board& board)
+{
+	FullKey key;
+	board.encode(key.data());
+	key[32] = board.whiteToMove() ? 'w' : 'b';
+	return key;
+}
+
+KeyAuditReport auditKeys(const vector<PgnGame>& games, size_t moves)
+{
+	KeyAuditReport report = { 0, 0, {}, {} };
+	unordered_map<uint64_t, vector<FullKey>> seen;
+
+	for (const auto& game : games)
+	{
+		Pgn pgn{ game };
+
+		if (!pgn.ok())
+		{
+			report.skipped.add(pgn.status());
+			continue;
+		}
+
+		Board board = pgn.startPosition();
+		report.games++;
+
+		for (size_t i = 0; i <= min(pgn.moveCount(), moves); ++i)
+		{
+			uint64_t key = zobristKey(board);
+			FullKey full = fullKey(board);
+			vector<FullKey>& boards = seen[key];
+
+			if (find(boards.begin(), boards.end(), full) == boards.end())
+			{
+				if (!boards.empty())
+				{
+					Board other;
+					other.decode(boards.front().data());
+
+					string otherFen = other.toFen();
+					otherFen[otherFen.find(' ') + 1] = boards.front()[32];
+
+					report.collisions.push_back({ key, board.toFen(), otherFen });
+				}
+
+				boards.push_back(full);
+				report.positions++;
+			}
+
+			if (i < min(pgn.moveCount(), moves))
+			{
+				board.makeMove(pgn.getMove(i));
+			}
+		}
+	}
+
+	return report;
+}
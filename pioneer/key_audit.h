@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "split_pgns.h"
+#include "board.h"
+#include "pgn.h"
+
+using namespace std;
+
+struct KeyCollision
+{
+	uint64_t key;
+	string first;
+	string second;
+};
+
+struct KeyAuditReport
+{
+	size_t games;
+	size_t positions;
+	vector<KeyCollision> collisions;
+	ParseErrorCounts skipped;
+};
+
+// Replays every game up to 'moves' plies with full boards as keys and
+// reports distinct positions that share a zobristKey, i.e. the positions a
+// COMPACT_FORMAT book would silently merge.
+KeyAuditReport auditKeys(const vector<PgnGame>& games, size_t moves);
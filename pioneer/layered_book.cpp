@@ -0,0 +1,144 @@
+#include <algorithm>
+#include "layered_book.h"
+
+using namespace std;
+
+constexpr double LAYER_FILTER_FP_RATE = 0.01;
+
+LayeredBook::LayeredBook() : mode(FIRST_HIT) {}
+
+void LayeredBook::addLayer(const BookLayer& layer)
+{
+    layer.book->buildFilter(LAYER_FILTER_FP_RATE);
+    layers.push_back(layer);
+
+    // Stable so equal priorities keep the order they were added in
+    stable_sort(layers.begin(), layers.end(), [](const BookLayer& a, const BookLayer& b)
+    {
+        return a.priority > b.priority;
+    });
+}
+
+void LayeredBook::clear()
+{
+    layers.clear();
+}
+
+void LayeredBook::setMode(LayerMode _mode)
+{
+    mode = _mode;
+}
+
+bool LayeredBook::isEmpty() const
+{
+    return layers.empty();
+}
+
+const vector<BookLayer>& LayeredBook::getLayers() const
+{
+    return layers;
+}
+
+// Each hitting layer contributes its moves' shares of that position, so a
+// small repertoire book and a huge general book blend by weight rather than
+// by raw game counts. Books without counts (legacy format) fall back to
+// rank-based shares.
+vector<BlendedMove> LayeredBook::probe(const Board& board) const
+{
+    vector<BlendedMove> blended;
+
+    for (const auto& layer : layers)
+    {
+        if (!layer.book->mayContain(board))
+        {
+            continue;
+        }
+
+        shared_ptr<const MoveList> entries = layer.book->find(board);
+        if (!entries || entries->empty())
+        {
+            continue;
+        }
+
+        double total = 0;
+        for (const auto& entry : *entries)
+        {
+            total += entry.count;
+        }
+
+        for (size_t i = 0; i < entries->size(); i++)
+        {
+            const MoveEntry& entry = (*entries)[i];
+            double share = total > 0
+                ? entry.count / total
+                : 2.0 * (entries->size() - i) / (entries->size() * (entries->size() + 1));
+
+            auto it = find_if(blended.begin(), blended.end(),
+                [&entry](const BlendedMove& move) { return move.move.cmp(entry.move); });
+
+            if (it == blended.end())
+            {
+                blended.push_back({ entry.move, layer.weight * share });
+            }
+            else
+            {
+                it->score += layer.weight * share;
+            }
+        }
+
+        if (mode == FIRST_HIT)
+        {
+            break;
+        }
+    }
+
+    stable_sort(blended.begin(), blended.end(), [](const BlendedMove& a, const BlendedMove& b)
+    {
+        return a.score > b.score;
+    });
+
+    return blended;
+}
+
+Move LayeredBook::getRankedMove(const Board& board, unsigned int rank) const
+{
+    vector<BlendedMove> moves = probe(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(rank < moves.size());
+
+    return rank < moves.size() ? moves[rank].move : Move::null();
+}
+
+// Samples proportionally to the blended score
+Move LayeredBook::getRandMove(const Board& board)
+{
+    vector<BlendedMove> moves = probe(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(!moves.empty());
+
+    if (moves.empty())
+    {
+        return Move::null();
+    }
+
+    double total = 0;
+    for (const auto& move : moves)
+    {
+        total += move.score;
+    }
+
+    double pick = (static_cast<unsigned char>(rng.generateByteNumber()) + 0.5) / 256.0 * total;
+
+    for (const auto& move : moves)
+    {
+        pick -= move.score;
+        if (pick <= 0)
+        {
+            return move.move;
+        }
+    }
+
+    return moves.back().move;
+}
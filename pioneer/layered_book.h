@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/rng.h"
+#include "book.h"
+
+using namespace std;
+
+enum LayerMode
+{
+    FIRST_HIT, // Highest-priority layer holding the position answers alone
+    BLEND      // Every layer holding the position contributes, scaled by weight
+};
+
+struct BookLayer
+{
+    string name;
+    shared_ptr<Book> book;
+    int priority;
+    double weight;
+};
+
+struct BlendedMove
+{
+    Move move;
+    double score;
+};
+
+// Several independently built books probed as one, highest priority first,
+// without merging them on disk.
+class LayeredBook
+{
+private:
+    vector<BookLayer> layers;
+    LayerMode mode;
+    RandomNumberGenerator rng;
+
+public:
+    LayeredBook();
+
+    void addLayer(const BookLayer& layer);
+    void clear();
+    void setMode(LayerMode mode);
+    bool isEmpty() const;
+    const vector<BookLayer>& getLayers() const;
+
+    vector<BlendedMove> probe(const Board& board) const;
+    Move getRankedMove(const Board& board, unsigned int rank) const;
+    Move getRandMove(const Board& board);
+};
@@ -0,0 +1,560 @@
+#include <filesystem>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+#include "block_book.h"
+#include "learner.h"
+
+using namespace std;
+
+BookLearner::BookLearner(LiveBook& _live)
+    : live(_live), pendingUpdates(0), recordedUpdates(0), generation(0), logGeneration(0), stopping(false), opened(false) {}
+
+BookLearner::~BookLearner()
+{
+    close();
+}
+
+uint32_t BookLearner::weight(bool whiteMoved, GameResult result)
+{
+    switch (result)
+    {
+    case WHITE_WINS: return whiteMoved ? 2 : 0;
+    case BLACK_WINS: return whiteMoved ? 0 : 2;
+    case DRAWN: return 1;
+    default: return 0;
+    }
+}
+
+// Reads a log header; false for a missing, torn or foreign one
+static bool readLogHeader(ifstream& in, uint32_t& generation)
+{
+    LearnLogHeader header;
+
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || memcmp(header.magic, LEARN_LOG_MAGIC, sizeof(header.magic)) != 0 || header.version != LEARN_LOG_VERSION)
+    {
+        return false;
+    }
+
+    generation = header.generation;
+    return true;
+}
+
+// Learning needs stored counts, so only block books qualify; the rewritten
+// book keeps the format and block size of the original. Updates left in the
+// logs by a previous session are replayed into the pending counts, unless
+// the book's generation shows they were folded in already.
+bool BookLearner::open(const string& path, const BookLoadOptions& options, unsigned intervalSeconds)
+{
+    close();
+
+    BlockBookReader reader;
+    if (!reader.open(path, 0) || !live.load(path, options))
+    {
+        return false;
+    }
+
+    bookPath = path;
+    logPath = path + ".log";
+    loadOptions = options;
+    writeOptions = BookWriteOptions();
+    writeOptions.format = reader.keysOnly() ? COMPACT_FORMAT : BLOCK_FORMAT;
+    writeOptions.blockSize = reader.blockSize();
+    writeOptions.packed = reader.packed();
+    writeOptions.keepVariations = true;
+    writeOptions.threads = options.threads;
+    generation = reader.generation();
+
+    pendingUpdates = 0;
+    recordedUpdates = 0;
+
+    // Rotated logs of failed or interrupted compactions come first
+    findRotated();
+
+    for (uint32_t rotatedGeneration : rotated)
+    {
+        replay(rotatedPath(rotatedGeneration));
+    }
+
+    ifstream existing(logPath, ios::binary);
+    error_code ignored;
+
+    if (readLogHeader(existing, logGeneration) && logGeneration > generation)
+    {
+        existing.close();
+
+        // Appends would land behind a torn or corrupt tail, out of step with the records
+        uint64_t goodEnd = replay(logPath);
+
+        if (filesystem::file_size(logPath, ignored) > goodEnd)
+        {
+            error_code error;
+            filesystem::resize_file(logPath, goodEnd, error);
+
+            if (error)
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        existing.close();
+        filesystem::remove(logPath, ignored);
+        logGeneration = max(generation, rotated.empty() ? 0 : rotated.back()) + 1;
+    }
+
+    {
+        lock_guard<mutex> lock(logMutex);
+
+        if (!openLog())
+        {
+            return false;
+        }
+    }
+
+    stopping = false;
+    opened = true;
+
+    if (intervalSeconds > 0)
+    {
+        compactor = thread([this, intervalSeconds]()
+        {
+            unique_lock<mutex> lock(wakeMutex);
+
+            while (!wake.wait_for(lock, chrono::seconds(intervalSeconds), [this]() { return stopping; }))
+            {
+                lock.unlock();
+
+                if (pendingUpdates > 0)
+                {
+                    compact();
+                }
+
+                lock.lock();
+            }
+        });
+    }
+
+    return true;
+}
+
+void BookLearner::close()
+{
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    if (compactor.joinable())
+    {
+        compactor.join();
+    }
+
+    lock_guard<mutex> lock(logMutex);
+
+    if (log.is_open())
+    {
+        log.close();
+    }
+
+    for (auto& stripe : stripes)
+    {
+        lock_guard<mutex> stripeLock(stripe.lock);
+        stripe.positions.clear();
+    }
+
+    opened = false;
+}
+
+bool BookLearner::isOpen() const
+{
+    return opened;
+}
+
+// The caller holds logMutex
+bool BookLearner::openLog()
+{
+    ifstream existing(logPath, ios::binary | ios::ate);
+    bool fresh = !existing.is_open() || existing.tellg() == 0;
+    existing.close();
+
+    log.open(logPath, ios::binary | ios::app);
+
+    if (fresh)
+    {
+        LearnLogHeader header = {};
+        memcpy(header.magic, LEARN_LOG_MAGIC, sizeof(header.magic));
+        header.version = LEARN_LOG_VERSION;
+        header.generation = logGeneration;
+
+        log.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        log.flush();
+    }
+
+    return log.good();
+}
+
+string BookLearner::rotatedPath(uint32_t rotatedGeneration) const
+{
+    return logPath + "." + to_string(rotatedGeneration);
+}
+
+// Lists the <log>.<generation> files of earlier compactions, oldest first,
+// and removes those the book already holds
+void BookLearner::findRotated()
+{
+    filesystem::path live(logPath);
+    filesystem::path dir = live.has_parent_path() ? live.parent_path() : filesystem::path(".");
+    string prefix = live.filename().string() + ".";
+    vector<filesystem::path> folded;
+    error_code error;
+
+    rotated.clear();
+
+    for (filesystem::directory_iterator it(dir, error), end; !error && it != end; it.increment(error))
+    {
+        string name = it->path().filename().string();
+
+        if (name.size() <= prefix.size() || name.size() > prefix.size() + 9 || name.compare(0, prefix.size(), prefix) != 0
+            || !all_of(name.begin() + prefix.size(), name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            continue;
+        }
+
+        uint32_t rotatedGeneration = static_cast<uint32_t>(stoul(name.substr(prefix.size())));
+
+        if (rotatedGeneration <= generation)
+        {
+            folded.push_back(it->path());
+        }
+        else
+        {
+            rotated.push_back(rotatedGeneration);
+        }
+    }
+
+    for (const auto& path : folded)
+    {
+        filesystem::remove(path, error);
+    }
+
+    sort(rotated.begin(), rotated.end());
+}
+
+// Skips logs the book's generation already covers; returns the offset just past the last good record
+uint64_t BookLearner::replay(const string& path)
+{
+    ifstream in(path, ios::binary);
+    uint32_t stamped;
+
+    if (!readLogHeader(in, stamped) || stamped <= generation)
+    {
+        return 0;
+    }
+
+    LearnRecord record;
+    uint64_t goodEnd = sizeof(LearnLogHeader);
+
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        if (crc32c(&record, offsetof(LearnRecord, checksum)) != record.checksum)
+        {
+            break;
+        }
+
+        // The board encoding drops the side to move, which the key needs
+        Board board;
+        board.decode(record.board);
+        board.setWhiteToMove(record.whiteToMove != 0);
+        apply(board, Move::decode(record.move), weight(record.whiteToMove != 0, static_cast<GameResult>(record.result)));
+        recordedUpdates++;
+        goodEnd += sizeof(record);
+    }
+
+    return goodEnd;
+}
+
+void BookLearner::apply(const Board& board, const Move& move, uint32_t points)
+{
+    uint64_t key = zobristKey(board);
+    Stripe& stripe = stripes[key % STRIPES];
+
+    {
+        lock_guard<mutex> lock(stripe.lock);
+        PendingPosition& position = stripe.positions.try_emplace(key, PendingPosition{ board, {} }).first->second;
+
+        auto it = find_if(position.moves.begin(), position.moves.end(),
+            [&](const PendingMove& pending) { return pending.move.cmp(move); });
+
+        if (it == position.moves.end())
+        {
+            position.moves.push_back({ move, points });
+        }
+        else
+        {
+            it->weight += points;
+        }
+    }
+
+    pendingUpdates++;
+}
+
+// The caller holds logMutex
+bool BookLearner::append(const LearnRecord& record)
+{
+    log.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    log.flush();
+    return log.good();
+}
+
+// Logged before it is counted, so an update that was counted can always be
+// recovered after a crash. Both happen under logMutex, so a compaction takes
+// either the record and its count or neither.
+bool BookLearner::record(const Board& board, const Move& move, GameResult result)
+{
+    if (!opened)
+    {
+        return false;
+    }
+
+    LearnRecord entry = {};
+    board.encode(entry.board);
+    entry.whiteToMove = board.whiteToMove() ? 1 : 0;
+    entry.result = result;
+    entry.move = move.encode();
+    entry.checksum = crc32c(&entry, offsetof(LearnRecord, checksum));
+
+    lock_guard<mutex> lock(logMutex);
+
+    if (!append(entry))
+    {
+        return false;
+    }
+
+    apply(board, move, weight(board.whiteToMove(), result));
+    recordedUpdates++;
+    return true;
+}
+
+// Records the game's positions up to the served book's depth
+size_t BookLearner::recordGame(const Pgn& game, GameResult result)
+{
+    size_t depth = min(game.moveCount(), live.acquire()->getMoveCount());
+    Board board = game.startPosition();
+    size_t recordedMoves = 0;
+
+    for (size_t i = 0; i < depth; i++)
+    {
+        Move move = game.getMove(i);
+
+        if (record(board, move, result))
+        {
+            recordedMoves++;
+        }
+
+        board.makeMove(move);
+    }
+
+    return recordedMoves;
+}
+
+// Takes the pending counts, rotates the log and reopens it in one hold of
+// logMutex, so no update is turned away meanwhile. Then rebuilds the book file
+// from disk with the counts added, stamped with the rotated log's generation,
+// renames it into place, reloads it and removes the rotated logs. If the
+// rebuild fails the taken counts are put back and the rotated logs are kept
+// for the next compaction to fold in.
+bool BookLearner::compact()
+{
+    lock_guard<mutex> compactLock(compactMutex);
+
+    if (!opened)
+    {
+        return false;
+    }
+
+    vector<PendingPosition> taken;
+    uint32_t target;
+    error_code rotateError;
+    bool reopened;
+
+    {
+        lock_guard<mutex> lock(logMutex);
+
+        for (auto& stripe : stripes)
+        {
+            lock_guard<mutex> stripeLock(stripe.lock);
+
+            for (auto& pair : stripe.positions)
+            {
+                taken.push_back(std::move(pair.second));
+            }
+
+            stripe.positions.clear();
+        }
+
+        pendingUpdates = 0;
+
+        target = logGeneration;
+        log.close();
+        filesystem::rename(logPath, rotatedPath(target), rotateError);
+
+        if (!rotateError)
+        {
+            rotated.push_back(target);
+            logGeneration = target + 1;
+        }
+
+        reopened = openLog();
+    }
+
+    Book book(0, 0);
+    string staged = bookPath + ".tmp";
+    error_code ignored;
+    bool ok = !rotateError && reopened && book.read_book(bookPath, writeOptions.threads);
+
+    if (ok)
+    {
+        for (const auto& position : taken)
+        {
+            for (const auto& pending : position.moves)
+            {
+                if (pending.weight > 0)
+                {
+                    book.insert(position.board, pending.move, pending.weight);
+                }
+            }
+        }
+
+        book.resize_vector(book.getVariations());
+
+        writeOptions.generation = target;
+        ok = book.write_book(staged, writeOptions);
+
+        if (ok)
+        {
+            error_code error;
+            filesystem::rename(staged, bookPath, error);
+            ok = !error;
+        }
+    }
+
+    if (!ok)
+    {
+        filesystem::remove(staged, ignored);
+
+        for (const auto& position : taken)
+        {
+            for (const auto& pending : position.moves)
+            {
+                apply(position.board, pending.move, pending.weight);
+            }
+        }
+
+        return false;
+    }
+
+    // A crash before the removals leaves logs the book's generation covers
+    generation = target;
+
+    for (uint32_t rotatedGeneration : rotated)
+    {
+        filesystem::remove(rotatedPath(rotatedGeneration), ignored);
+    }
+
+    rotated.clear();
+    return live.load(bookPath, loadOptions);
+}
+
+shared_ptr<const MoveList> BookLearner::find(const Board& board)
+{
+    shared_ptr<Book> book = live.acquire();
+    shared_ptr<const MoveList> entries = book->find(board);
+
+    uint64_t key = zobristKey(board);
+    Stripe& stripe = stripes[key % STRIPES];
+    MoveList merged;
+
+    {
+        lock_guard<mutex> lock(stripe.lock);
+        auto it = stripe.positions.find(key);
+
+        if (it == stripe.positions.end())
+        {
+            return entries;
+        }
+
+        // A plain copy would take the published book's arena allocator
+        if (entries)
+        {
+            merged.assign(entries->begin(), entries->end());
+        }
+
+        for (const auto& pending : it->second.moves)
+        {
+            auto entry = find_if(merged.begin(), merged.end(),
+                [&](const MoveEntry& stored) { return stored.move.cmp(pending.move); });
+
+            if (entry != merged.end())
+            {
+                entry->count += pending.weight;
+            }
+            else if (pending.weight > 0)
+            {
+                merged.push_back(MoveEntry(pending.move, pending.weight));
+            }
+        }
+    }
+
+    stable_sort(merged.begin(), merged.end(), [](const MoveEntry& a, const MoveEntry& b) { return a.count > b.count; });
+
+    if (merged.size() > book->getVariations())
+    {
+        merged.resize(book->getVariations());
+    }
+
+    return make_shared<const MoveList>(std::move(merged));
+}
+
+Move BookLearner::getRankedMove(const Board& board, unsigned int rank)
+{
+    shared_ptr<const MoveList> entries = find(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(entries && entries->size() > rank);
+
+    return entries && entries->size() > rank ? (*entries)[rank].move : Move::null();
+}
+
+// Uniform over the moves, as Book::getRandMove
+Move BookLearner::getRandMove(const Board& board)
+{
+    static thread_local RandomNumberGenerator rng;
+
+    shared_ptr<const MoveList> entries = find(board);
+
+    PhaseTimer timer(PHASE_SAMPLE);
+    timer.setHit(entries && !entries->empty());
+
+    if (!entries || entries->empty())
+    {
+        return Move::null();
+    }
+
+    return (*entries)[static_cast<unsigned char>(rng.generateByteNumber()) % entries->size()].move;
+}
+
+uint64_t BookLearner::pending() const
+{
+    return pendingUpdates;
+}
+
+uint64_t BookLearner::recorded() const
+{
+    return recordedUpdates;
+}
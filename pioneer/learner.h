@@ -0,0 +1,141 @@
+#pragma once
+
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
+#include <fstream>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include "utils/crc32c.h"
+#include "game_archive.h"
+#include "live_book.h"
+#include "board.h"
+#include "pgn.h"
+
+using namespace std;
+
+// Learning log, <book>.log: header, then fixed-size records appended as
+// updates arrive. A torn or corrupt tail record ends the replay.
+//
+//   header := magic 4B | version u32 | generation u32
+//   record := board 32B | white to move u8 | result u8 | move i16 | crc32c u32
+//
+// A log's generation is that of the compaction that will fold it in.
+// Compaction renames the log to <book>.log.<generation> and writes the book
+// with that generation in its header (BlockHeader::generation), so logs the
+// book already holds are recognised and dropped even when a crash left them
+// behind.
+
+constexpr char LEARN_LOG_MAGIC[4] = { 'P', 'N', 'L', 'G' };
+constexpr uint32_t LEARN_LOG_VERSION = 2;
+
+struct LearnLogHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t generation;
+};
+
+struct LearnRecord
+{
+    char board[32];
+    uint8_t whiteToMove;
+    uint8_t result;
+    int16_t move;
+    uint32_t checksum;
+};
+
+static_assert(sizeof(LearnLogHeader) == 12, "LearnLogHeader must be packed");
+static_assert(sizeof(LearnRecord) == 40, "LearnRecord must be packed");
+
+// Counts learned from finished games, kept beside the served book until
+// compaction folds them into the book file. Updates take the log lock for
+// the append and, within it, the lock of one of STRIPES stripes (by position
+// key). Probes through the learner read the published book and lay the
+// pending counts of the position over it, holding only its stripe's lock
+// while they copy them; they never wait on the log. Compaction rewrites the
+// book off to the side and swaps it in through LiveBook.
+class BookLearner
+{
+public:
+    static constexpr size_t STRIPES = 64;
+
+    BookLearner(LiveBook& live);
+    ~BookLearner();
+
+    BookLearner(const BookLearner&) = delete;
+    BookLearner& operator=(const BookLearner&) = delete;
+
+    bool open(const string& bookPath, const BookLoadOptions& options, unsigned intervalSeconds);
+    void close();
+    bool isOpen() const;
+
+    bool record(const Board& board, const Move& move, GameResult result);
+    size_t recordGame(const Pgn& game, GameResult result);
+    bool compact();
+
+    uint64_t pending() const;
+    uint64_t recorded() const;
+
+    // The served book's moves with the pending counts added, ranked and cut
+    // to its variations as compaction would
+    shared_ptr<const MoveList> find(const Board& board);
+    Move getRankedMove(const Board& board, unsigned int rank);
+    Move getRandMove(const Board& board);
+
+    // Score points for the side that played the move: win 2, draw 1, loss 0
+    static uint32_t weight(bool whiteMoved, GameResult result);
+
+private:
+    struct PendingMove
+    {
+        Move move;
+        uint32_t weight;
+    };
+
+    struct PendingPosition
+    {
+        Board board;
+        vector<PendingMove> moves;
+    };
+
+    struct Stripe
+    {
+        mutex lock;
+        unordered_map<uint64_t, PendingPosition> positions;
+    };
+
+    LiveBook& live;
+    string bookPath;
+    string logPath;
+    BookLoadOptions loadOptions;
+    BookWriteOptions writeOptions;
+
+    Stripe stripes[STRIPES];
+    atomic<uint64_t> pendingUpdates;
+    atomic<uint64_t> recordedUpdates;
+
+    mutex logMutex;
+    ofstream log;
+    uint32_t generation;      // Of the served book
+    uint32_t logGeneration;   // Of the live log
+    vector<uint32_t> rotated; // Generations of the rotated logs not yet folded in
+
+    mutex compactMutex;
+    thread compactor;
+    condition_variable wake;
+    mutex wakeMutex;
+    bool stopping;
+    bool opened;
+
+    void apply(const Board& board, const Move& move, uint32_t weight);
+    bool append(const LearnRecord& record);
+    bool openLog();
+    string rotatedPath(uint32_t logGeneration) const;
+    void findRotated();
+    uint64_t replay(const string& path);
+};
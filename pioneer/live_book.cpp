@@ -0,0 +1,107 @@
+#include "live_book.h"
+
+using namespace std;
+
+LiveBook::LiveBook() : current(make_shared<Book>(0, 0)), reloading(false) {}
+
+LiveBook::~LiveBook()
+{
+    lock_guard<mutex> lock(reloadMutex);
+
+    if (reloader.joinable())
+    {
+        reloader.join();
+    }
+}
+
+shared_ptr<Book> LiveBook::acquire() const
+{
+    return current.load(memory_order_acquire);
+}
+
+void LiveBook::publish(shared_ptr<Book> book)
+{
+    shared_ptr<Book> previous = current.exchange(std::move(book), memory_order_acq_rel);
+
+    {
+        lock_guard<mutex> lock(retiredMutex);
+        retired.push_back(std::move(previous));
+    }
+
+    reclaim();
+}
+
+// A retired book is unreachable for new probes, so a use count of one means
+// the list holds the last reference.
+void LiveBook::reclaim()
+{
+    vector<shared_ptr<Book>> released;
+
+    {
+        lock_guard<mutex> lock(retiredMutex);
+
+        for (auto it = retired.begin(); it != retired.end();)
+        {
+            if (it->use_count() == 1)
+            {
+                released.push_back(std::move(*it));
+                it = retired.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+// Blocking load that still never exposes a partially filled book
+bool LiveBook::load(const string& path, const BookLoadOptions& options)
+{
+    shared_ptr<Book> book = make_shared<Book>(0, 0);
+
+    if (!book->load(path, options))
+    {
+        return false;
+    }
+
+    publish(book);
+    return true;
+}
+
+// Returns false if a reload is already in flight. 'done' runs on the
+// reload thread once the new book is published (or failed to load).
+bool LiveBook::reloadAsync(const string& path, const BookLoadOptions& options, function<void(bool)> done)
+{
+    lock_guard<mutex> lock(reloadMutex);
+
+    if (reloading.exchange(true))
+    {
+        return false;
+    }
+
+    reclaim();
+
+    if (reloader.joinable())
+    {
+        reloader.join();
+    }
+
+    reloader = thread([this, path, options, done]()
+    {
+        bool ok = load(path, options);
+        reloading.store(false);
+
+        if (done)
+        {
+            done(ok);
+        }
+    });
+
+    return true;
+}
+
+bool LiveBook::isReloading() const
+{
+    return reloading.load();
+}
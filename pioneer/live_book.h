@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include "book.h"
+
+using namespace std;
+
+// The book currently served to probes. A reload builds a complete new Book
+// off to the side and publishes it with one atomic pointer swap; probes hold
+// a shared_ptr to the version they started with, so the previous book is
+// retired only after the last in-flight probe releases it.
+class LiveBook
+{
+private:
+    atomic<shared_ptr<Book>> current;
+    mutex reloadMutex;
+    thread reloader;
+    atomic<bool> reloading;
+
+    // Replaced versions wait here until no probe references them, so their
+    // teardown runs on the publishing thread rather than inside a probe.
+    mutex retiredMutex;
+    vector<shared_ptr<Book>> retired;
+
+    void reclaim();
+
+public:
+    LiveBook();
+    ~LiveBook();
+
+    LiveBook(const LiveBook&) = delete;
+    LiveBook& operator=(const LiveBook&) = delete;
+
+    shared_ptr<Book> acquire() const;
+    void publish(shared_ptr<Book> book);
+    bool load(const string& path, const BookLoadOptions& options);
+    bool reloadAsync(const string& path, const BookLoadOptions& options, function<void(bool)> done);
+    bool isReloading() const;
+};
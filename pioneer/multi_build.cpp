@@ -0,0 +1,142 @@
+#include <algorithm>
+#include "multi_build.h"
+
+using namespace std;
+
+MultiBookBuilder::MultiBookBuilder(vector<BookConfig> _configs, bool bounded) : configs(std::move(_configs)), games(0), index(nullptr), indexDepth(0)
+{
+    stable_sort(configs.begin(), configs.end(),
+        [](const BookConfig& a, const BookConfig& b) { return a.moves < b.moves; });
+
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        partials.push_back(make_shared<Book>(configs[i].variations, configs[i].moves));
+        partials.back()->setBounded(bounded);
+
+        while (plyPartial.size() < configs[i].moves)
+        {
+            plyPartial.push_back(i);
+        }
+    }
+}
+
+// Records which game reached each position up to 'depth' plies
+void MultiBookBuilder::setIndex(PositionIndexBuilder* _index, size_t depth)
+{
+    index = _index;
+    indexDepth = min(depth, plyPartial.size());
+}
+
+// Every configuration keeps only the positions of one key shard
+void MultiBookBuilder::setShard(uint32_t shard, uint32_t shards)
+{
+    for (auto& partial : partials)
+    {
+        partial->setShard(shard, shards);
+    }
+}
+
+template <class Game>
+void MultiBookBuilder::replay(const Game& game, size_t plies, uint32_t id)
+{
+    Board board = game.startPosition();
+    games += 1;
+
+    for (size_t i = 0; i < min(plies, plyPartial.size()); ++i)
+    {
+        Move move = game.getMove(i);
+        partials[plyPartial[i]]->insert(board, move);
+
+        if (index && i < indexDepth)
+        {
+            index->add(board, id);
+        }
+
+        board.makeMove(move);
+    }
+}
+
+void MultiBookBuilder::insertFromPgn(const Pgn& pgn, uint32_t id)
+{
+    replay(pgn, pgn.moveCount(), id);
+}
+
+void MultiBookBuilder::insertFromArchive(const ArchivedGame& game, uint32_t id)
+{
+    replay(game, game.plies, id);
+}
+
+size_t MultiBookBuilder::partialCount() const
+{
+    return partials.size();
+}
+
+Book& MultiBookBuilder::partial(size_t i)
+{
+    return *partials[i];
+}
+
+size_t MultiBookBuilder::gameCount() const
+{
+    return games;
+}
+
+void MultiBookBuilder::addGames(size_t count)
+{
+    games += count;
+}
+
+// Both builders must have been made from the same configurations
+void MultiBookBuilder::merge(const MultiBookBuilder& other)
+{
+    for (size_t i = 0; i < partials.size(); i++)
+    {
+        partials[i]->merge(*other.partials[i]);
+    }
+
+    games += other.games;
+}
+
+// Emits books shallowest first. The running total is copied out for every
+// configuration except the deepest, which takes the total itself; with a
+// single configuration nothing is copied at all.
+bool MultiBookBuilder::build(const function<bool(const BookConfig&, const shared_ptr<Book>&)>& emit)
+{
+    shared_ptr<Book> total;
+
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        const BookConfig& config = configs[i];
+
+        if (!total)
+        {
+            total = partials[i];
+        }
+        else
+        {
+            total->merge(*partials[i]);
+        }
+
+        partials[i].reset();
+
+        shared_ptr<Book> book = total;
+
+        if (i + 1 < configs.size())
+        {
+            book = make_shared<Book>(config.variations, config.moves);
+            book->merge(*total);
+        }
+
+        book->setVariations(config.variations);
+        book->setMoveCount(config.moves);
+        book->setGameCount(games);
+        book->resize_vector(config.variations);
+
+        if (!emit(config, book))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "position_index.h"
+#include "game_archive.h"
+#include "book.h"
+#include "pgn.h"
+
+using namespace std;
+
+struct BookConfig
+{
+    string path;
+    size_t variations;
+    size_t moves;
+};
+
+// Builds several books from one pass over the games. Every ply is counted
+// once, into the partial table of the shallowest configuration that still
+// covers it; a configuration's book is then the sum of its own partial table
+// and all shallower ones, accumulated in depth order.
+class MultiBookBuilder
+{
+private:
+    vector<BookConfig> configs;
+    vector<shared_ptr<Book>> partials;
+    vector<size_t> plyPartial;
+    size_t games;
+    PositionIndexBuilder* index;
+    size_t indexDepth;
+
+    template <class Game>
+    void replay(const Game& game, size_t plies, uint32_t id);
+
+public:
+    MultiBookBuilder(vector<BookConfig> configs, bool bounded);
+
+    void setIndex(PositionIndexBuilder* index, size_t depth);
+    void setShard(uint32_t shard, uint32_t shards);
+    void insertFromPgn(const Pgn& pgn, uint32_t id);
+    void insertFromArchive(const ArchivedGame& game, uint32_t id);
+    // Per-configuration partial tables, so the contribution of one chunk of
+    // input can be cached and merged into another builder (see chunk_cache.h)
+    size_t partialCount() const;
+    Book& partial(size_t i);
+    size_t gameCount() const;
+    void addGames(size_t count);
+    void merge(const MultiBookBuilder& other);
+
+    bool build(const function<bool(const BookConfig&, const shared_ptr<Book>&)>& emit);
+};
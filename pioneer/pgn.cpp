@@ -1,49 +1,110 @@
 #include "pgn.h"
+#include "game_filter.h"
 
 using namespace std;
 
-Pgn::Pgn(const string& pgn)
+Pgn::Pgn(string_view movetext, const Board& _start) : start(_start), error(PARSE_OK), setUp(false)
 {
-    size_t move_start = pgn.find("\n\n");
-    string moves_str = pgn.substr(0, move_start);
-
-    size_t start = 0;
-    size_t end = 0;
+    parse(movetext);
+}
 
-    Board board;
+// Only games from a set-up position carry a FEN tag, so the plain find keeps
+// the common case off the tag scanner
+Pgn::Pgn(const PgnGame& game) : error(PARSE_OK), setUp(false)
+{
+    if (game.tags.find("[FEN ") != string_view::npos)
+    {
+        setUp = true;
+        error = Board::parseFen(scanTags(game.tags).fen, start);
 
-    for (char& c : moves_str) {
-        if (c == '\n') {
-            c = ' ';
+        if (error != PARSE_OK)
+        {
+            return;
         }
     }
 
-    while ((end = moves_str.find(" ", start)) != string::npos)
+    parse(game.movetext);
+}
+
+// Tokens are string_views into the movetext, so decoding a game allocates
+// nothing beyond the move list. Comments, NAGs and variations are skipped.
+void Pgn::parse(string_view pgn)
+{
+    pgn = pgn.substr(0, pgn.find("\n\n"));
+
+    Board board = start;
+    size_t pos = 0;
+
+    while (pos < pgn.length())
     {
-        string token = moves_str.substr(start, end - start);
-        size_t dot = token.find(".");
+        char c = pgn[pos];
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            pos++;
+            continue;
+        }
+
+        if (c == '{' || c == ';')
+        {
+            size_t close = pgn.find(c == '{' ? '}' : '\n', pos);
+            pos = close == string_view::npos ? pgn.length() : close + 1;
+            continue;
+        }
 
-        if (dot != string::npos)
+        if (c == '(')
+        {
+            int depth = 0;
+
+            for (; pos < pgn.length(); pos++)
+            {
+                if (pgn[pos] == '{')
+                {
+                    pos = min(pgn.find('}', pos), pgn.length() - 1);
+                }
+                else if (pgn[pos] == '(')
+                {
+                    depth++;
+                }
+                else if (pgn[pos] == ')' && --depth == 0)
+                {
+                    break;
+                }
+            }
+
+            pos++;
+            continue;
+        }
+
+        size_t end = pgn.find_first_of(" \t\r\n{;(", pos);
+        string_view token = pgn.substr(pos, end == string_view::npos ? string_view::npos : end - pos);
+        pos = end == string_view::npos ? pgn.length() : end;
+
+        size_t dot = token.find_last_of('.');
+        if (dot != string_view::npos)
         {
             token = token.substr(dot + 1);
         }
 
-        if (token.empty())
+        if (token.empty() || token[0] == '$')
         {
-            start = end + 1;
             continue;
         }
 
-        if (token == "1/2-1/2" || token == "1-0" || token == "0-1") {
+        if (token == "1/2-1/2" || token == "1-0" || token == "0-1" || token == "*") {
             break;
         }
 
-        Move move(board.sanToUci(token));
+        Move move;
+        error = board.sanToMove(token, move);
+
+        if (error != PARSE_OK)
+        {
+            return;
+        }
 
         board.makeMove(move);
         moves.push_back(move);
-
-        start = end + 1;
     }
 }
 
@@ -56,3 +117,126 @@ size_t Pgn::moveCount() const
 {
     return moves.size();
 }
+
+const Board& Pgn::startPosition() const
+{
+    return start;
+}
+
+bool Pgn::fromSetUp() const
+{
+    return setUp;
+}
+
+ParseError Pgn::status() const
+{
+    return error;
+}
+
+bool Pgn::ok() const
+{
+    return error == PARSE_OK;
+}
+
+size_t ParseErrorCounts::total() const
+{
+    size_t sum = 0;
+
+    for (size_t count : counts)
+    {
+        sum += count;
+    }
+
+    return sum;
+}
+
+// "unknown piece 1, ambiguous move 2"
+string ParseErrorCounts::summary() const
+{
+    string text;
+
+    for (size_t i = PARSE_OK + 1; i < PARSE_ERROR_COUNT; i++)
+    {
+        if (counts[i] > 0)
+        {
+            text += (text.empty() ? "" : ", ") + string(parseErrorName(static_cast<ParseError>(i))) + " " + to_string(counts[i]);
+        }
+    }
+
+    return text;
+}
+
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+static uint64_t fnv1a(uint64_t hash, string_view bytes)
+{
+    for (char c : bytes)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+// Identity tags of the seven tag roster; other tags (annotators, sources,
+// opening names) differ between re-exports of the same game.
+static bool isRosterTag(string_view name)
+{
+    return name == "Event" || name == "Site" || name == "Date" || name == "Round"
+        || name == "White" || name == "Black" || name == "Result";
+}
+
+// Hashes the roster tags in file order and the movetext with whitespace runs
+// collapsed, without tokenizing or decoding any SAN.
+uint64_t gameFingerprint(const PgnGame& game)
+{
+    uint64_t hash = FNV_OFFSET;
+    string_view tags = game.tags;
+
+    while (!tags.empty())
+    {
+        size_t eol = tags.find('\n');
+        string_view line = tags.substr(0, eol);
+        tags = eol == string_view::npos ? string_view() : tags.substr(eol + 1);
+
+        size_t space = line.find(' ');
+        if (line.empty() || line[0] != '[' || space == string_view::npos)
+        {
+            continue;
+        }
+
+        if (isRosterTag(line.substr(1, space - 1)))
+        {
+            hash = fnv1a(hash, line);
+        }
+    }
+
+    bool pendingSpace = false;
+    bool started = false;
+
+    for (char c : game.movetext)
+    {
+        if (isspace(static_cast<unsigned char>(c)))
+        {
+            pendingSpace = true;
+            continue;
+        }
+
+        if (pendingSpace && started)
+        {
+            hash = (hash ^ ' ') * FNV_PRIME;
+        }
+
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+        pendingSpace = false;
+        started = true;
+    }
+
+    // Finalize so the low bits are usable as a table index
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    return hash;
+}
@@ -2,17 +2,45 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include "split_pgns.h"
 #include "board.h"
 
 using namespace std;
 
+// A game's moves resolved against its start position. Parsing never throws:
+// the first move that does not resolve stops it, status() says why, and the
+// moves before it are kept.
 class Pgn
 {
 private:
 	vector<Move> moves;
+	Board start;
+	ParseError error;
+	bool setUp;
+
+	void parse(string_view movetext);
 
 public:
-	Pgn(const string& pgn);
+	Pgn(string_view movetext, const Board& start = Board());
+	Pgn(const PgnGame& game);
 	Move getMove(size_t index) const;
 	size_t moveCount() const;
+	const Board& startPosition() const;
+	bool fromSetUp() const;
+	ParseError status() const;
+	bool ok() const;
+};
+
+// Per-category tally of games skipped during ingest
+struct ParseErrorCounts
+{
+	size_t counts[PARSE_ERROR_COUNT] = {};
+
+	void add(ParseError error) { counts[error]++; }
+	void add(const ParseErrorCounts& other) { for (size_t i = 0; i < PARSE_ERROR_COUNT; i++) counts[i] += other.counts[i]; }
+	size_t total() const;
+	string summary() const;
 };
+
+uint64_t gameFingerprint(const PgnGame& game);
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstring>
+#include "position_index.h"
+
+using namespace std;
+
+// Games are added in input order, so a list stays sorted and a position seen
+// twice in one game only needs comparing against the last id.
+void PositionIndexBuilder::add(const Board& board, uint32_t game)
+{
+    vector<uint32_t>& games = postings[zobristKey(board)];
+
+    if (games.empty() || games.back() != game)
+    {
+        games.push_back(game);
+    }
+}
+
+bool PositionIndexBuilder::write(const string& path) const
+{
+    vector<uint64_t> keys;
+    keys.reserve(postings.size());
+
+    for (const auto& pair : postings)
+    {
+        keys.push_back(pair.first);
+    }
+
+    sort(keys.begin(), keys.end());
+
+    vector<PositionIndexEntry> directory;
+    vector<char> lists;
+    directory.reserve(keys.size());
+
+    for (uint64_t key : keys)
+    {
+        const vector<uint32_t>& games = postings.at(key);
+        PositionIndexEntry entry = { key, lists.size(), static_cast<uint32_t>(games.size()), 0 };
+
+        uint32_t previous = 0;
+        for (uint32_t game : games)
+        {
+            putVarint(lists, game - previous);
+            previous = game;
+        }
+
+        entry.size = static_cast<uint32_t>(lists.size() - entry.offset);
+        directory.push_back(entry);
+    }
+
+    PositionIndexHeader header = {};
+    memcpy(header.magic, POSITION_INDEX_MAGIC, sizeof(header.magic));
+    header.version = POSITION_INDEX_VERSION;
+    header.keyCount = directory.size();
+    header.postingBytes = lists.size();
+
+    OutputFile file;
+    bool ok = file.open(path, false)
+        && file.write(reinterpret_cast<const char*>(&header), sizeof(header))
+        && file.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(PositionIndexEntry))
+        && file.write(lists.data(), lists.size());
+
+    return file.close() && ok;
+}
+
+size_t PositionIndexBuilder::positions() const
+{
+    return postings.size();
+}
+
+PositionIndex::PositionIndex() : directory(nullptr), lists(nullptr), keyCount(0), postingBytes(0) {}
+
+bool PositionIndex::open(const string& path)
+{
+    if (!file.open(path) || file.size() < sizeof(PositionIndexHeader)
+        || memcmp(file.data(), POSITION_INDEX_MAGIC, sizeof(POSITION_INDEX_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    PositionIndexHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (header.version != POSITION_INDEX_VERSION
+        || sizeof(header) + header.keyCount * sizeof(PositionIndexEntry) + header.postingBytes != file.size())
+    {
+        return false;
+    }
+
+    // The header is 32 bytes and the mapping page aligned, so the directory
+    // can be read in place.
+    directory = reinterpret_cast<const PositionIndexEntry*>(file.data() + sizeof(header));
+    lists = file.data() + sizeof(header) + header.keyCount * sizeof(PositionIndexEntry);
+    keyCount = header.keyCount;
+    postingBytes = header.postingBytes;
+
+    file.adviseRandom();
+    return true;
+}
+
+bool PositionIndex::find(const Board& board, vector<uint32_t>& games) const
+{
+    games.clear();
+
+    uint64_t key = zobristKey(board);
+    const PositionIndexEntry* end = directory + keyCount;
+    const PositionIndexEntry* it = lower_bound(directory, end, key,
+        [](const PositionIndexEntry& entry, uint64_t key) { return entry.key < key; });
+
+    if (it == end || it->key != key || it->offset + it->size > postingBytes)
+    {
+        return false;
+    }
+
+    games.reserve(it->count);
+
+    const char* in = lists + it->offset;
+    const char* listEnd = in + it->size;
+    uint64_t game = 0;
+
+    for (uint32_t i = 0; i < it->count; i++)
+    {
+        uint64_t delta;
+        if (!(in = getVarint(in, listEnd, delta)))
+        {
+            return false;
+        }
+
+        game += delta;
+        games.push_back(static_cast<uint32_t>(game));
+    }
+
+    return true;
+}
+
+size_t PositionIndex::positions() const
+{
+    return keyCount;
+}
+
+vector<uint32_t> intersectGames(const vector<uint32_t>& a, const vector<uint32_t>& b)
+{
+    vector<uint32_t> both;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(both));
+    return both;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/mapped_file.h"
+#include "utils/zobrist.h"
+#include "utils/file_io.h"
+#include "utils/varint.h"
+#include "board.h"
+
+using namespace std;
+
+// Position index layout, written next to a book as <book>.idx: header,
+// directory sorted by zobristKey, posting lists.
+//
+//   posting list := count * varint(game id delta)
+//
+// Game ids are the 0-based order of the games in the make input (before
+// filtering), ascending within a list; the first delta is from 0.
+
+constexpr char POSITION_INDEX_MAGIC[4] = { 'P', 'N', 'G', 'I' };
+constexpr uint16_t POSITION_INDEX_VERSION = 1;
+
+struct PositionIndexHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t reserved;
+    uint64_t keyCount;
+    uint64_t postingBytes;
+};
+
+struct PositionIndexEntry
+{
+    uint64_t key;
+    uint64_t offset;
+    uint32_t count;
+    uint32_t size;
+};
+
+static_assert(sizeof(PositionIndexHeader) == 32, "PositionIndexHeader must be packed");
+static_assert(sizeof(PositionIndexEntry) == 24, "PositionIndexEntry must be packed");
+
+class PositionIndexBuilder
+{
+private:
+    unordered_map<uint64_t, vector<uint32_t>> postings;
+
+public:
+    void add(const Board& board, uint32_t game);
+    bool write(const string& path) const;
+    size_t positions() const;
+};
+
+class PositionIndex
+{
+private:
+    MappedFile file;
+    const PositionIndexEntry* directory;
+    const char* lists;
+    uint64_t keyCount;
+    uint64_t postingBytes;
+
+public:
+    PositionIndex();
+
+    bool open(const string& path);
+    bool find(const Board& board, vector<uint32_t>& games) const;
+    size_t positions() const;
+};
+
+vector<uint32_t> intersectGames(const vector<uint32_t>& a, const vector<uint32_t>& b);
@@ -0,0 +1,214 @@
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include "utils/zobrist.h"
+#include "block_book.h"
+#include "preview.h"
+
+using namespace std;
+
+ReservoirSampler::ReservoirSampler(size_t _capacity, uint64_t seed)
+	: capacity(_capacity), seen(0), rng(seed) {}
+
+bool ReservoirSampler::admit(size_t& slot)
+{
+	seen++;
+
+	if (seen <= capacity)
+	{
+		slot = seen - 1;
+		return true;
+	}
+
+	uint64_t pick = uniform_int_distribution<uint64_t>(0, seen - 1)(rng);
+
+	if (pick >= capacity)
+	{
+		return false;
+	}
+
+	slot = static_cast<size_t>(pick);
+	return true;
+}
+
+size_t ReservoirSampler::offered() const
+{
+	return seen;
+}
+
+struct Line
+{
+	Board board;
+	vector<Move> moves;
+};
+
+struct SampleEntry
+{
+	uint32_t count;
+	vector<Move> replies;
+};
+
+// Bytes per record at 'stored' moves on average, block and filter overhead
+// included
+static double recordBytes(const PreviewOptions& options, double stored)
+{
+	if (options.format == LEGACY_FORMAT)
+	{
+		return 32.0 + options.variations * sizeof(int16_t); // Book::recordSize
+	}
+
+	double record = sizeof(uint64_t) + 1 + stored * (sizeof(int16_t) + sizeof(uint32_t));
+
+	if (options.format == BLOCK_FORMAT)
+	{
+		record += 32;
+	}
+
+	double perBlock = sizeof(uint32_t) + sizeof(BlockIndexEntry);
+	double filter = -log(BLOCK_FILTER_FP_RATE) / (log(2.0) * log(2.0)) / 8; // Bloom filter bytes per key
+	return record * (1.0 + perBlock / max<uint32_t>(options.blockSize, 1)) + filter;
+}
+
+// Distinct positions of the whole corpus from a sample of 'fraction' of its
+// games, by Shlosser's estimator. frequencies[i] is the number of sampled
+// positions seen i times; positions seen often are in the sample anyway,
+// while rare ones stand for up to 1/fraction positions each.
+static double extrapolate(const vector<size_t>& frequencies, size_t positions, double fraction)
+{
+	if (frequencies.size() < 2 || frequencies[1] == 0 || fraction >= 1.0)
+	{
+		return static_cast<double>(positions);
+	}
+
+	double unseen = 0, seen = 0;
+
+	for (size_t i = 1; i < frequencies.size(); i++)
+	{
+		unseen += pow(1 - fraction, static_cast<double>(i)) * frequencies[i];
+		seen += i * fraction * pow(1 - fraction, static_cast<double>(i - 1)) * frequencies[i];
+	}
+
+	return positions + frequencies[1] * unseen / seen;
+}
+
+static PreviewReport previewLines(vector<Line>& lines, size_t sampled, size_t corpus, const PreviewOptions& options)
+{
+	PreviewReport report = { lines.size(), corpus, {}, {} };
+	unordered_map<uint64_t, SampleEntry> entries;
+	vector<uint64_t> keys(lines.size());
+
+	double fraction = corpus > 0 ? min(1.0, static_cast<double>(sampled) / corpus) : 1.0;
+	vector<size_t> frequencies(1);
+	size_t stored = 0;
+
+	for (size_t ply = 0; ply < options.moves; ply++)
+	{
+		size_t reached = 0;
+
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			Line& line = lines[i];
+
+			if (ply >= line.moves.size())
+			{
+				continue;
+			}
+
+			Move move = line.moves[ply];
+			keys[i] = zobristKey(line.board);
+			reached++;
+
+			SampleEntry& entry = entries[keys[i]];
+			if (entry.count > 0)
+			{
+				frequencies[entry.count]--;
+			}
+
+			if (++entry.count == frequencies.size())
+			{
+				frequencies.push_back(0);
+			}
+
+			frequencies[entry.count]++;
+
+			bool known = any_of(entry.replies.begin(), entry.replies.end(), [&](const Move& reply) { return reply.cmp(move); });
+
+			if (!known)
+			{
+				entry.replies.push_back(move);
+
+				if (entry.replies.size() <= options.variations)
+				{
+					stored++;
+				}
+			}
+
+			line.board.makeMove(move);
+		}
+
+		size_t covered = 0;
+
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			if (ply < lines[i].moves.size() && entries[keys[i]].count > 1)
+			{
+				covered++;
+			}
+		}
+
+		PreviewDepth depth;
+		depth.depth = ply + 1;
+		depth.positions = entries.size();
+		depth.estimatedPositions = extrapolate(frequencies, entries.size(), fraction);
+		depth.estimatedBytes = depth.estimatedPositions * recordBytes(options, entries.empty() ? 0.0 : static_cast<double>(stored) / entries.size());
+		depth.coverage = reached > 0 ? static_cast<double>(covered) / reached : 0.0;
+		report.depths.push_back(depth);
+	}
+
+	return report;
+}
+
+PreviewReport previewBook(const vector<PgnGame>& sample, size_t corpus, const PreviewOptions& options)
+{
+	vector<Line> lines;
+	ParseErrorCounts skipped;
+
+	for (const auto& game : sample)
+	{
+		Pgn pgn{ game };
+
+		if (!pgn.ok())
+		{
+			skipped.add(pgn.status());
+			continue;
+		}
+
+		lines.push_back({ pgn.startPosition(), {} });
+
+		for (size_t i = 0; i < min(pgn.moveCount(), options.moves); i++)
+		{
+			lines.back().moves.push_back(pgn.getMove(i));
+		}
+	}
+
+	PreviewReport report = previewLines(lines, sample.size(), corpus, options);
+	report.skipped = skipped;
+	return report;
+}
+
+PreviewReport previewBook(const vector<ArchivedGame>& sample, size_t corpus, const PreviewOptions& options)
+{
+	vector<Line> lines;
+
+	for (const auto& game : sample)
+	{
+		lines.push_back({ game.startPosition(), {} });
+
+		for (size_t i = 0; i < min<size_t>(game.plies, options.moves); i++)
+		{
+			lines.back().moves.push_back(game.getMove(i));
+		}
+	}
+
+	return previewLines(lines, sample.size(), corpus, options);
+}
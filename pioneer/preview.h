@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "split_pgns.h"
+#include "game_archive.h"
+#include "book.h"
+#include "pgn.h"
+
+using namespace std;
+
+// Uniform sample of a stream of unknown length (Algorithm R): after n offers
+// every item has been kept with probability capacity / n.
+class ReservoirSampler
+{
+private:
+	size_t capacity;
+	size_t seen;
+	mt19937_64 rng;
+
+public:
+	ReservoirSampler(size_t capacity, uint64_t seed);
+
+	// Offers the next item; true with the slot it takes, which is a new slot
+	// until the reservoir is full and the slot of an evicted item after
+	bool admit(size_t& slot);
+	size_t offered() const;
+};
+
+// A sampled game copied out of its chunk
+struct SampledGame
+{
+	string tags;
+	string movetext;
+
+	PgnGame view() const { return { tags, movetext }; }
+};
+
+struct PreviewOptions
+{
+	size_t variations;
+	size_t moves;
+	BookFormat format;
+	uint32_t blockSize;
+};
+
+struct PreviewDepth
+{
+	size_t depth;
+	size_t positions;          // Positions of a book built from the sample
+	double estimatedPositions; // Extrapolated to the full corpus
+	double estimatedBytes;     // Book file size at estimatedPositions
+	double coverage;           // Sampled games whose position at this depth another game also reached
+};
+
+struct PreviewReport
+{
+	size_t games;
+	size_t corpus;
+	vector<PreviewDepth> depths;
+	ParseErrorCounts skipped;
+};
+
+// Replays the sample ply by ply and reports every depth from 1 to
+// options.moves, as if one book were built per depth from 'corpus' games.
+PreviewReport previewBook(const vector<PgnGame>& sample, size_t corpus, const PreviewOptions& options);
+PreviewReport previewBook(const vector<ArchivedGame>& sample, size_t corpus, const PreviewOptions& options);
@@ -18,3 +18,80 @@ vector<string> splitPgns(const string& pgns)
 
 	return pgn_s;
 }
+
+
+// Same pairing as splitPgns, but keeps the tag section and returns views
+// into 'pgns' instead of copies.
+vector<PgnGame> splitGames(const string& pgns)
+{
+	vector<PgnGame> games;
+	string_view rest(pgns);
+	string_view tags;
+	size_t part = 0;
+
+	while (true)
+	{
+		size_t end = rest.find("\n\n");
+		string_view piece = rest.substr(0, end);
+
+		if ((part & 0b1) == 1)
+		{
+			games.push_back({ tags, piece });
+		}
+		else
+		{
+			tags = piece;
+		}
+
+		if (end == string_view::npos)
+		{
+			break;
+		}
+
+		rest = rest.substr(end + 2);
+		part++;
+	}
+
+	return games;
+}
+
+PgnChunkReader::PgnChunkReader(size_t _chunkSize) : chunkSize(_chunkSize) {}
+
+bool PgnChunkReader::open(const string& path)
+{
+	file.open(path, ios::binary);
+	carry.clear();
+
+	return file.is_open();
+}
+
+bool PgnChunkReader::next(string& chunk)
+{
+	chunk = move(carry);
+	carry.clear();
+
+	while (true)
+	{
+		size_t used = chunk.size();
+		chunk.resize(used + chunkSize);
+		file.read(&chunk[used], chunkSize);
+		chunk.resize(used + static_cast<size_t>(file.gcount()));
+
+		// Movetext never starts with '[', so a blank line followed by one
+		// always opens a tag section
+		size_t boundary = chunk.rfind("\n\n[");
+
+		if (boundary != string::npos)
+		{
+			carry.assign(chunk, boundary + 2, string::npos);
+			chunk.resize(boundary + 2);
+			return true;
+		}
+
+		// A single game longer than the chunk keeps reading
+		if (!file)
+		{
+			return !chunk.empty();
+		}
+	}
+}
@@ -1,9 +1,37 @@
 #pragma once
 
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "utils\split.h"
 
 using namespace std;
 
+struct PgnGame
+{
+	string_view tags;
+	string_view movetext;
+};
+
 vector<string> splitPgns(const string& pgns);
+vector<PgnGame> splitGames(const string& pgns);
+
+// Reads a PGN file a chunk at a time. Chunks end where the next game's tag
+// section begins, so splitGames on each chunk yields whole games while only
+// one chunk is resident.
+class PgnChunkReader
+{
+private:
+	ifstream file;
+	string carry;
+	size_t chunkSize;
+
+public:
+	explicit PgnChunkReader(size_t chunkSize = 8 << 20);
+
+	bool open(const string& path);
+
+	// False once the file is exhausted
+	bool next(string& chunk);
+};
@@ -0,0 +1,185 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+Arena::Arena() : freeLists(), cursor(nullptr), limit(nullptr), total(0), hugePages(HUGE_PAGES_OFF), nextHugePages(HUGE_PAGES_OFF), locked(false) {}
+
+Arena::~Arena()
+{
+    reset();
+}
+
+size_t Arena::classOf(size_t size)
+{
+    if (size <= FINE_CLASSES * 16)
+    {
+        return (max<size_t>(size, 1) - 1) / 16;
+    }
+
+    size_t sizeClass = FINE_CLASSES;
+    size_t classBytes = FINE_CLASSES * 16 * 2;
+
+    while (classBytes < size)
+    {
+        classBytes <<= 1;
+        sizeClass++;
+    }
+
+    return sizeClass;
+}
+
+size_t Arena::classSize(size_t sizeClass)
+{
+    if (sizeClass < FINE_CLASSES)
+    {
+        return (sizeClass + 1) * 16;
+    }
+
+    return (FINE_CLASSES * 16) << (sizeClass - FINE_CLASSES + 1);
+}
+
+// A mapping that cannot be locked is still used; lock() reports the failure
+char* Arena::mapPages(size_t size)
+{
+    char* ptr = mapAnonymous(size, hugePages);
+
+    if (ptr != nullptr && locked)
+    {
+        lockPages(ptr, mappingSize(size, hugePages));
+    }
+
+    return ptr;
+}
+
+void Arena::unmapPages(char* ptr, size_t size)
+{
+    unmapAnonymous(ptr, size, hugePages);
+}
+
+void* Arena::allocate(size_t size)
+{
+    if (size > MAX_CLASS_SIZE)
+    {
+        char* ptr = mapPages(size);
+        if (ptr == nullptr)
+        {
+            throw bad_alloc();
+        }
+
+        large.emplace_back(ptr, size);
+        total += mappingSize(size, hugePages);
+        return ptr;
+    }
+
+    size_t sizeClass = classOf(size);
+
+    if (freeLists[sizeClass] != nullptr)
+    {
+        FreeBlock* block = freeLists[sizeClass];
+        freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    size_t bytes = classSize(sizeClass);
+
+    if (cursor == nullptr || static_cast<size_t>(limit - cursor) < bytes)
+    {
+        char* slab = mapPages(SLAB_SIZE);
+        if (slab == nullptr)
+        {
+            throw bad_alloc();
+        }
+
+        slabs.emplace_back(slab, SLAB_SIZE);
+        total += mappingSize(SLAB_SIZE, hugePages);
+        cursor = slab;
+        limit = slab + SLAB_SIZE;
+    }
+
+    void* ptr = cursor;
+    cursor += bytes;
+    return ptr;
+}
+
+// Class-sized blocks go back on their free list; large mappings (old hash
+// table bucket arrays) are released immediately.
+void Arena::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    if (size > MAX_CLASS_SIZE)
+    {
+        auto it = find_if(large.begin(), large.end(),
+            [ptr](const pair<char*, size_t>& mapping) { return mapping.first == ptr; });
+
+        if (it != large.end())
+        {
+            unmapPages(it->first, it->second);
+            total -= mappingSize(it->second, hugePages);
+            large.erase(it);
+        }
+
+        return;
+    }
+
+    size_t sizeClass = classOf(size);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = freeLists[sizeClass];
+    freeLists[sizeClass] = block;
+}
+
+void Arena::reset()
+{
+    for (const auto& slab : slabs)
+    {
+        unmapPages(slab.first, slab.second);
+    }
+
+    for (const auto& mapping : large)
+    {
+        unmapPages(mapping.first, mapping.second);
+    }
+
+    slabs.clear();
+    large.clear();
+    fill(begin(freeLists), end(freeLists), nullptr);
+
+    cursor = nullptr;
+    limit = nullptr;
+    total = 0;
+    locked = false;
+    hugePages = nextHugePages;
+}
+
+size_t Arena::reserved() const
+{
+    return total;
+}
+
+void Arena::setHugePages(HugePages _hugePages)
+{
+    nextHugePages = _hugePages;
+}
+
+bool Arena::lock()
+{
+    bool ok = true;
+    locked = true;
+
+    for (const auto& slab : slabs)
+    {
+        ok = lockPages(slab.first, mappingSize(slab.second, hugePages)) && ok;
+    }
+
+    for (const auto& mapping : large)
+    {
+        ok = lockPages(mapping.first, mappingSize(mapping.second, hugePages)) && ok;
+    }
+
+    return ok;
+}
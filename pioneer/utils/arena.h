@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <new>
+#include "pages.h"
+
+using namespace std;
+
+// Slab arena for long-lived build structures. Small requests are bump
+// allocated from large slabs and recycled through per-size-class free lists;
+// reset() returns every slab to the OS at once.
+class Arena
+{
+public:
+    static constexpr size_t SLAB_SIZE = 4 << 20;
+    static constexpr size_t MAX_CLASS_SIZE = 1 << 20;
+
+    Arena();
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+    void reset();
+    size_t reserved() const;
+
+    // Takes effect at the next reset(), so every live mapping keeps the
+    // page size it was made with
+    void setHugePages(HugePages hugePages);
+
+    // Locks every current mapping and each one mapped until the next reset()
+    bool lock();
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // 16-byte steps up to 1 KB, then powers of two up to MAX_CLASS_SIZE
+    static constexpr size_t FINE_CLASSES = 64;
+    static constexpr size_t CLASS_COUNT = FINE_CLASSES + 11;
+
+    vector<pair<char*, size_t>> slabs;
+    vector<pair<char*, size_t>> large;
+    FreeBlock* freeLists[CLASS_COUNT];
+    char* cursor;
+    char* limit;
+    size_t total;
+    HugePages hugePages;
+    HugePages nextHugePages;
+    bool locked;
+
+    static size_t classOf(size_t size);
+    static size_t classSize(size_t sizeClass);
+    char* mapPages(size_t size);
+    void unmapPages(char* ptr, size_t size);
+};
+
+// Allocator over an Arena; a null arena falls back to the global heap so the
+// same container types work outside a Book.
+template <class T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    Arena* arena;
+
+    ArenaAllocator(Arena* _arena = nullptr) noexcept : arena(_arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n)
+    {
+        if (arena == nullptr)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if (arena == nullptr)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena == other.arena;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena != other.arena;
+    }
+};
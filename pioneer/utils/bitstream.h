@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <vector>
+
+using namespace std;
+
+inline unsigned bitWidth(uint64_t value)
+{
+    unsigned width = 0;
+
+    while (value != 0)
+    {
+        width++;
+        value >>= 1;
+    }
+
+    return width;
+}
+
+// Elias gamma code length of 'value' >= 1
+inline size_t gammaBits(uint64_t value)
+{
+    return 2 * bitWidth(value) - 1;
+}
+
+// Rice codes escape to a raw 64-bit value once the quotient reaches this
+constexpr unsigned RICE_ESCAPE = 32;
+
+inline size_t riceBits(uint64_t value, unsigned k)
+{
+    uint64_t quotient = value >> k;
+    return quotient < RICE_ESCAPE ? quotient + 1 + k : RICE_ESCAPE + 64;
+}
+
+// LSB-first bit packing into a byte vector; finish() pads the last byte.
+class BitWriter
+{
+private:
+    vector<char>& out;
+    uint64_t pending;
+    unsigned count;
+
+public:
+    explicit BitWriter(vector<char>& _out) : out(_out), pending(0), count(0) {}
+
+    void put(uint64_t value, unsigned bits)
+    {
+        if (bits > 32)
+        {
+            put(value & 0xFFFFFFFF, 32);
+            put(value >> 32, bits - 32);
+            return;
+        }
+
+        pending |= (value & ((uint64_t(1) << bits) - 1)) << count;
+        count += bits;
+
+        while (count >= 8)
+        {
+            out.push_back(static_cast<char>(pending));
+            pending >>= 8;
+            count -= 8;
+        }
+    }
+
+    // Unary length prefix, then the bits below the leading one
+    void putGamma(uint64_t value)
+    {
+        unsigned width = bitWidth(value);
+        put(0, width - 1);
+        put(1, 1);
+        put(value, width - 1);
+    }
+
+    void putRice(uint64_t value, unsigned k)
+    {
+        uint64_t quotient = value >> k;
+
+        if (quotient >= RICE_ESCAPE)
+        {
+            put(0, RICE_ESCAPE);
+            put(value, 64);
+            return;
+        }
+
+        put(0, static_cast<unsigned>(quotient));
+        put(1, 1);
+        put(value, k);
+    }
+
+    void finish()
+    {
+        if (count > 0)
+        {
+            out.push_back(static_cast<char>(pending));
+            pending = 0;
+            count = 0;
+        }
+    }
+};
+
+// Reads what BitWriter wrote, refilling a 64-bit window a byte at a time.
+// Running past 'end' yields zeros and clears ok().
+class BitReader
+{
+private:
+    const char* in;
+    const char* end;
+    uint64_t pending; // Bits above 'count' are always zero
+    unsigned count;
+    bool overrun;
+
+    void refill()
+    {
+        while (count <= 56 && in != end)
+        {
+            pending |= static_cast<uint64_t>(static_cast<uint8_t>(*in++)) << count;
+            count += 8;
+        }
+    }
+
+    void skip(unsigned bits)
+    {
+        pending = bits >= 64 ? 0 : pending >> bits;
+        count -= bits;
+    }
+
+    // Counts zero bits up to the next one bit and consumes both, or consumes
+    // exactly 'limit' zeros and returns 'limit'
+    unsigned zeros(unsigned limit)
+    {
+        unsigned found = 0;
+
+        while (true)
+        {
+            if (count == 0)
+            {
+                refill();
+
+                if (count == 0)
+                {
+                    overrun = true;
+                    return limit;
+                }
+            }
+
+            unsigned run = pending != 0 ? static_cast<unsigned>(countr_zero(pending)) : count;
+
+            if (found + run >= limit)
+            {
+                skip(limit - found);
+                return limit;
+            }
+
+            if (pending != 0)
+            {
+                skip(run + 1);
+                return found + run;
+            }
+
+            found += run;
+            skip(run);
+        }
+    }
+
+public:
+    BitReader(const char* _in, const char* _end) : in(_in), end(_end), pending(0), count(0), overrun(false) {}
+
+    uint64_t get(unsigned bits)
+    {
+        if (bits > 32)
+        {
+            uint64_t low = get(32);
+            return low | (get(bits - 32) << 32);
+        }
+
+        if (count < bits)
+        {
+            refill();
+
+            if (count < bits)
+            {
+                overrun = true;
+                return 0;
+            }
+        }
+
+        uint64_t value = pending & ((uint64_t(1) << bits) - 1);
+        skip(bits);
+        return value;
+    }
+
+    uint64_t getGamma()
+    {
+        unsigned width = zeros(64);
+
+        if (width == 64)
+        {
+            overrun = true;
+            return 0;
+        }
+
+        return (uint64_t(1) << width) | get(width);
+    }
+
+    uint64_t getRice(unsigned k)
+    {
+        unsigned quotient = zeros(RICE_ESCAPE);
+
+        if (quotient == RICE_ESCAPE)
+        {
+            return get(64);
+        }
+
+        return (static_cast<uint64_t>(quotient) << k) | get(k);
+    }
+
+    bool ok() const
+    {
+        return !overrun;
+    }
+};
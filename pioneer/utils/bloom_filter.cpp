@@ -0,0 +1,87 @@
+#include "bloom_filter.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static uint64_t secondHash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53;
+    key ^= key >> 33;
+    return key | 1;
+}
+
+BloomFilter::BloomFilter() : bitCount(0), hashes(0) {}
+
+// Optimal sizing: m = -n ln p / (ln 2)^2 bits and k = m / n ln 2 hashes
+BloomFilter::BloomFilter(size_t expected, double falsePositiveRate)
+{
+    double n = static_cast<double>(max<size_t>(expected, 1));
+    double ln2 = log(2.0);
+
+    bitCount = max<uint64_t>(static_cast<uint64_t>(ceil(-n * log(falsePositiveRate) / (ln2 * ln2))), 64);
+    hashes = max<uint32_t>(static_cast<uint32_t>(round(bitCount / n * ln2)), 1);
+    bits.assign((bitCount + 63) / 64, 0);
+}
+
+// 'words' must hold at least bitCount bits
+BloomFilter::BloomFilter(vector<uint64_t> words, uint64_t _bitCount, uint32_t _hashes)
+    : bits(move(words)), bitCount(_bitCount), hashes(_hashes) {}
+
+void BloomFilter::add(uint64_t key)
+{
+    uint64_t step = secondHash(key);
+
+    for (uint32_t i = 0; i < hashes; i++, key += step)
+    {
+        uint64_t bit = key % bitCount;
+        bits[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool BloomFilter::mayContain(uint64_t key) const
+{
+    if (bits.empty())
+    {
+        return true;
+    }
+
+    uint64_t step = secondHash(key);
+
+    for (uint32_t i = 0; i < hashes; i++, key += step)
+    {
+        uint64_t bit = key % bitCount;
+        if ((bits[bit >> 6] & (1ULL << (bit & 63))) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BloomFilter::isEmpty() const
+{
+    return bits.empty();
+}
+
+size_t BloomFilter::bytes() const
+{
+    return bits.size() * sizeof(uint64_t);
+}
+
+const vector<uint64_t>& BloomFilter::words() const
+{
+    return bits;
+}
+
+uint64_t BloomFilter::size() const
+{
+    return bitCount;
+}
+
+uint32_t BloomFilter::hashCount() const
+{
+    return hashes;
+}
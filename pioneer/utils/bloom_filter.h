@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Bloom filter over 64-bit keys that are already well mixed (zobrist keys).
+// Probe positions come from double hashing: h1 + i * h2.
+class BloomFilter
+{
+public:
+    BloomFilter();
+    BloomFilter(size_t expected, double falsePositiveRate);
+    BloomFilter(vector<uint64_t> words, uint64_t bitCount, uint32_t hashes);
+
+    void add(uint64_t key);
+    bool mayContain(uint64_t key) const;
+    bool isEmpty() const;
+    size_t bytes() const;
+
+    // Raw state, for storing a filter inside another file
+    const vector<uint64_t>& words() const;
+    uint64_t size() const;
+    uint32_t hashCount() const;
+
+private:
+    vector<uint64_t> bits;
+    uint64_t bitCount;
+    uint32_t hashes;
+};
@@ -0,0 +1,137 @@
+#include <cstring>
+#include "crc32c.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+using namespace std;
+
+constexpr uint32_t CRC32C_POLY = 0x82F63B78; // reflected 0x1EDC6F41
+
+struct Crc32cTable
+{
+    uint32_t entries[256];
+
+    constexpr Crc32cTable() : entries()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+            }
+
+            entries[i] = crc;
+        }
+    }
+};
+
+static constexpr Crc32cTable TABLE;
+
+static uint32_t crc32cSoftware(const unsigned char* in, size_t size, uint32_t crc)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = TABLE.entries[(crc ^ in[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+#if CRC32C_X86
+
+#ifdef __GNUC__
+__attribute__((target("sse4.2")))
+#endif
+static uint32_t crc32cHardwareImpl(const unsigned char* in, size_t size, uint32_t crc)
+{
+    uint64_t crc64 = crc;
+
+    for (; size >= 8; in += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, in, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    uint32_t crc32 = static_cast<uint32_t>(crc64);
+
+    for (; size > 0; in++, size--)
+    {
+        crc32 = _mm_crc32_u8(crc32, *in);
+    }
+
+    return crc32;
+}
+
+static bool detectHardware()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#elif CRC32C_ARM
+
+static uint32_t crc32cHardwareImpl(const unsigned char* in, size_t size, uint32_t crc)
+{
+    for (; size >= 8; in += 8, size -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, in, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+
+    for (; size > 0; in++, size--)
+    {
+        crc = __crc32cb(crc, *in);
+    }
+
+    return crc;
+}
+
+static bool detectHardware()
+{
+    return true;
+}
+
+#endif
+
+bool crc32cHardware()
+{
+#if CRC32C_X86 || CRC32C_ARM
+    static const bool supported = detectHardware();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc)
+{
+    const unsigned char* in = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+
+#if CRC32C_X86 || CRC32C_ARM
+    if (crc32cHardware())
+    {
+        return ~crc32cHardwareImpl(in, size, crc);
+    }
+#endif
+
+    return ~crc32cSoftware(in, size, crc);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// CRC32C (Castagnoli). Uses the SSE4.2 or ARMv8 CRC instructions when the
+// CPU has them and a table otherwise; all paths give the same result.
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+bool crc32cHardware();
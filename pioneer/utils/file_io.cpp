@@ -0,0 +1,206 @@
+#include "file_io.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static char* allocateAligned(size_t size)
+{
+#ifdef _WIN32
+    return static_cast<char*>(_aligned_malloc(size, OutputFile::ALIGNMENT));
+#else
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, OutputFile::ALIGNMENT, size) == 0 ? static_cast<char*>(ptr) : nullptr;
+#endif
+}
+
+static void freeAligned(char* ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+OutputFile::OutputFile() : fd(-1), direct(false), staging(nullptr), staged(0), written(0) {}
+
+OutputFile::~OutputFile()
+{
+    close();
+}
+
+bool OutputFile::open(const string& path, bool _direct)
+{
+    close();
+    written = 0;
+    staged = 0;
+    direct = false;
+
+#ifdef _WIN32
+    fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+#ifdef O_DIRECT
+    if (_direct)
+    {
+        fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        direct = fd >= 0;
+    }
+#endif
+
+    // Filesystems such as tmpfs reject O_DIRECT, fall back to buffered writes
+    if (fd < 0)
+    {
+        fd = ::open(path.c_str(), flags, 0644);
+    }
+#endif
+
+    if (direct)
+    {
+        staging = allocateAligned(STAGING_SIZE);
+
+        if (staging == nullptr)
+        {
+            close();
+            return false;
+        }
+    }
+
+    return fd >= 0;
+}
+
+bool OutputFile::writeRaw(const char* data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        int n = _write(fd, data, static_cast<unsigned int>(min<size_t>(size, 1 << 30)));
+#else
+        ssize_t n = ::write(fd, data, size);
+#endif
+        if (n <= 0)
+        {
+            return false;
+        }
+
+        data += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+bool OutputFile::flushStaging(bool final)
+{
+    size_t size = staged;
+
+    if (final)
+    {
+        size = (staged + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        memset(staging + staged, 0, size - staged);
+    }
+
+    if (!writeRaw(staging, size))
+    {
+        return false;
+    }
+
+    staged = 0;
+    return true;
+}
+
+bool OutputFile::write(const char* data, size_t size)
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    written += size;
+
+    if (!direct)
+    {
+        return writeRaw(data, size);
+    }
+
+    while (size > 0)
+    {
+        size_t chunk = min(size, STAGING_SIZE - staged);
+        memcpy(staging + staged, data, chunk);
+
+        staged += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (staged == STAGING_SIZE && !flushStaging(false))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool OutputFile::close(bool syncToDisk)
+{
+    if (fd < 0)
+    {
+        return true;
+    }
+
+    bool ok = true;
+
+    if (direct && staged > 0)
+    {
+        ok = flushStaging(true);
+    }
+
+#ifdef _WIN32
+    if (syncToDisk)
+    {
+        ok = (_commit(fd) == 0) && ok;
+    }
+
+    ok = (_close(fd) == 0) && ok;
+#else
+    // The padded O_DIRECT tail is cut back to the logical length
+    if (direct)
+    {
+        ok = (ftruncate(fd, written) == 0) && ok;
+    }
+
+    if (syncToDisk)
+    {
+        ok = (fsync(fd) == 0) && ok;
+    }
+
+    ok = (::close(fd) == 0) && ok;
+#endif
+
+    if (staging != nullptr)
+    {
+        freeAligned(staging);
+        staging = nullptr;
+    }
+
+    fd = -1;
+    direct = false;
+    return ok;
+}
+
+bool OutputFile::isDirect() const
+{
+    return direct;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Unbuffered sequential writer for large payloads. With direct I/O the page
+// cache is bypassed (O_DIRECT), so writes are staged in an aligned buffer and
+// the padded tail is truncated away on close.
+class OutputFile
+{
+public:
+    static constexpr size_t ALIGNMENT = 4096;
+    static constexpr size_t STAGING_SIZE = 4 << 20;
+
+    OutputFile();
+    ~OutputFile();
+
+    bool open(const string& path, bool direct);
+    bool write(const char* data, size_t size);
+    bool close(bool syncToDisk = false);
+    bool isDirect() const;
+
+private:
+    int fd;
+    bool direct;
+    char* staging;
+    size_t staged;
+    uint64_t written;
+
+    bool writeRaw(const char* data, size_t size);
+    bool flushStaging(bool final);
+};
@@ -0,0 +1,109 @@
+#include "fingerprint_set.h"
+
+using namespace std;
+
+static size_t slotCountFor(size_t expected)
+{
+    size_t slots = 16;
+
+    while (slots < expected * 2)
+    {
+        slots <<= 1;
+    }
+
+    return slots;
+}
+
+FingerprintSet::FingerprintSet(size_t expected) : slots(slotCountFor(expected), 0), count(0), hasZero(false) {}
+
+// Returns false when the fingerprint was already present.
+bool FingerprintSet::insert(uint64_t fingerprint)
+{
+    if (fingerprint == 0)
+    {
+        bool inserted = !hasZero;
+        hasZero = true;
+        return inserted;
+    }
+
+    if ((count + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t i = static_cast<size_t>(fingerprint) & mask;
+
+    while (slots[i] != 0)
+    {
+        if (slots[i] == fingerprint)
+        {
+            return false;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    slots[i] = fingerprint;
+    count += 1;
+    return true;
+}
+
+bool FingerprintSet::contains(uint64_t fingerprint) const
+{
+    if (fingerprint == 0)
+    {
+        return hasZero;
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t i = static_cast<size_t>(fingerprint) & mask;
+
+    while (slots[i] != 0)
+    {
+        if (slots[i] == fingerprint)
+        {
+            return true;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return false;
+}
+
+void FingerprintSet::grow()
+{
+    vector<uint64_t> old(slots.size() * 2, 0);
+    old.swap(slots);
+
+    size_t mask = slots.size() - 1;
+
+    for (uint64_t fingerprint : old)
+    {
+        if (fingerprint == 0)
+        {
+            continue;
+        }
+
+        size_t i = static_cast<size_t>(fingerprint) & mask;
+        while (slots[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+
+        slots[i] = fingerprint;
+    }
+}
+
+size_t FingerprintSet::size() const
+{
+    return count + (hasZero ? 1 : 0);
+}
+
+void FingerprintSet::clear()
+{
+    vector<uint64_t>(16, 0).swap(slots);
+    count = 0;
+    hasZero = false;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Exact set of 64-bit fingerprints in a flat open-addressed table, 8 bytes
+// per slot at no more than half load.
+class FingerprintSet
+{
+public:
+    FingerprintSet(size_t expected = 0);
+
+    bool insert(uint64_t fingerprint);
+    bool contains(uint64_t fingerprint) const;
+    size_t size() const;
+    void clear();
+
+private:
+    vector<uint64_t> slots;
+    size_t count;
+    bool hasZero; // 0 marks an empty slot, so it is tracked separately
+
+    void grow();
+};
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <mutex>
+#include "latency.h"
+
+using namespace std;
+
+const char* phaseName(ProbePhase phase)
+{
+    switch (phase)
+    {
+    case PHASE_FEN: return "fen";
+    case PHASE_HASH: return "hash";
+    case PHASE_LOOKUP: return "lookup";
+    case PHASE_SAMPLE: return "sample";
+    default: return "?";
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+static unsigned highestBit(uint64_t value)
+{
+    unsigned bit = 0;
+    while (value >>= 1)
+    {
+        bit++;
+    }
+
+    return bit;
+}
+
+// Values below 2^SUB_BITS get a bucket each; above that the top SUB_BITS + 1
+// significant bits pick the bucket.
+size_t LatencyHistogram::bucketOf(uint64_t value)
+{
+    value = min<uint64_t>(value, (uint64_t(1) << MAX_BITS) - 1);
+
+    if (value < (uint64_t(1) << SUB_BITS))
+    {
+        return static_cast<size_t>(value);
+    }
+
+    unsigned shift = highestBit(value) - SUB_BITS;
+    return ((shift + 1) << SUB_BITS) | ((value >> shift) & ((1 << SUB_BITS) - 1));
+}
+
+// Lower bound of a bucket
+uint64_t LatencyHistogram::bucketValue(size_t bucket)
+{
+    if (bucket < (size_t(1) << SUB_BITS))
+    {
+        return bucket;
+    }
+
+    unsigned shift = static_cast<unsigned>(bucket >> SUB_BITS) - 1;
+    return (uint64_t((1 << SUB_BITS) | (bucket & ((1 << SUB_BITS) - 1)))) << shift;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    atomic<uint64_t>& bucket = counts[bucketOf(nanoseconds)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+void LatencyHistogram::mergeInto(vector<uint64_t>& totals) const
+{
+    totals.resize(BUCKETS, 0);
+
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        totals[i] += counts[i].load(memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& count : counts)
+    {
+        count.store(0, memory_order_relaxed);
+    }
+}
+
+struct ThreadTelemetry
+{
+    LatencyHistogram phases[PHASE_COUNT];
+    atomic<uint64_t> hits[PHASE_COUNT] = {};
+    atomic<uint64_t> misses[PHASE_COUNT] = {};
+};
+
+static atomic<bool> enabled(true);
+static mutex registryMutex;
+static vector<unique_ptr<ThreadTelemetry>> registry;
+
+static ThreadTelemetry& local()
+{
+    static thread_local ThreadTelemetry* telemetry = nullptr;
+
+    if (!telemetry)
+    {
+        lock_guard<mutex> lock(registryMutex);
+        registry.push_back(make_unique<ThreadTelemetry>());
+        telemetry = registry.back().get();
+    }
+
+    return *telemetry;
+}
+
+void ProbeTelemetry::record(ProbePhase phase, uint64_t nanoseconds)
+{
+    local().phases[phase].record(nanoseconds);
+}
+
+void ProbeTelemetry::count(ProbePhase phase, bool hit)
+{
+    atomic<uint64_t>& counter = hit ? local().hits[phase] : local().misses[phase];
+    counter.store(counter.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+void ProbeTelemetry::setEnabled(bool _enabled)
+{
+    enabled.store(_enabled, memory_order_relaxed);
+}
+
+bool ProbeTelemetry::isEnabled()
+{
+    return enabled.load(memory_order_relaxed);
+}
+
+// Resets while other threads record may drop a few samples; acceptable for
+// telemetry.
+void ProbeTelemetry::reset()
+{
+    lock_guard<mutex> lock(registryMutex);
+
+    for (auto& telemetry : registry)
+    {
+        for (size_t phase = 0; phase < PHASE_COUNT; phase++)
+        {
+            telemetry->phases[phase].reset();
+            telemetry->hits[phase].store(0, memory_order_relaxed);
+            telemetry->misses[phase].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+static uint64_t percentile(const vector<uint64_t>& totals, uint64_t count, double fraction)
+{
+    uint64_t rank = max<uint64_t>(static_cast<uint64_t>(fraction * count + 0.5), 1);
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < totals.size(); i++)
+    {
+        seen += totals[i];
+        if (seen >= rank)
+        {
+            return LatencyHistogram::bucketValue(i);
+        }
+    }
+
+    return 0;
+}
+
+vector<PhaseSummary> ProbeTelemetry::summarize()
+{
+    lock_guard<mutex> lock(registryMutex);
+    vector<PhaseSummary> summaries;
+
+    for (size_t phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        vector<uint64_t> totals;
+        PhaseSummary summary = { static_cast<ProbePhase>(phase), 0, 0, 0, 0, 0, 0, 0 };
+
+        for (const auto& telemetry : registry)
+        {
+            telemetry->phases[phase].mergeInto(totals);
+            summary.hits += telemetry->hits[phase].load(memory_order_relaxed);
+            summary.misses += telemetry->misses[phase].load(memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < totals.size(); i++)
+        {
+            summary.count += totals[i];
+
+            if (totals[i] > 0)
+            {
+                summary.max = LatencyHistogram::bucketValue(i);
+            }
+        }
+
+        if (summary.count > 0)
+        {
+            summary.p50 = percentile(totals, summary.count, 0.5);
+            summary.p99 = percentile(totals, summary.count, 0.99);
+            summary.p999 = percentile(totals, summary.count, 0.999);
+        }
+
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
+
+// One JSON object, latencies in nanoseconds
+string ProbeTelemetry::toJson(const vector<PhaseSummary>& summaries)
+{
+    ostringstream out;
+    out << "{";
+
+    for (size_t i = 0; i < summaries.size(); i++)
+    {
+        const PhaseSummary& s = summaries[i];
+
+        out << (i ? "," : "") << "\"" << phaseName(s.phase) << "\":{"
+            << "\"count\":" << s.count << ",\"p50\":" << s.p50 << ",\"p99\":" << s.p99
+            << ",\"p999\":" << s.p999 << ",\"max\":" << s.max
+            << ",\"hits\":" << s.hits << ",\"misses\":" << s.misses << "}";
+    }
+
+    out << "}";
+    return out.str();
+}
+
+PhaseTimer::PhaseTimer(ProbePhase _phase) : phase(_phase), active(ProbeTelemetry::isEnabled()), outcome(-1)
+{
+    if (active)
+    {
+        start = chrono::steady_clock::now();
+    }
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    ProbeTelemetry::record(phase, static_cast<uint64_t>(elapsed.count()));
+
+    if (outcome >= 0)
+    {
+        ProbeTelemetry::count(phase, outcome == 1);
+    }
+}
+
+void PhaseTimer::setHit(bool hit)
+{
+    outcome = hit ? 1 : 0;
+}
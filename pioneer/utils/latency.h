@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum ProbePhase
+{
+    PHASE_FEN,
+    PHASE_HASH,
+    PHASE_LOOKUP,
+    PHASE_SAMPLE,
+    PHASE_COUNT
+};
+
+const char* phaseName(ProbePhase phase);
+
+// Log-linear latency histogram in the style of HdrHistogram: each power of
+// two is split into 2^SUB_BITS buckets, so any recorded nanosecond value is
+// kept to within ~3%. Only the owning thread records; counters are relaxed
+// atomics so a reporter may read them concurrently.
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr unsigned MAX_BITS = 40; // ~18 minutes in ns
+    static constexpr size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+    void mergeInto(vector<uint64_t>& totals) const;
+    void reset();
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t bucketValue(size_t bucket);
+
+private:
+    atomic<uint64_t> counts[BUCKETS];
+};
+
+struct PhaseSummary
+{
+    ProbePhase phase;
+    uint64_t count;
+    uint64_t p50, p99, p999, max;
+    uint64_t hits, misses;
+};
+
+// Process-wide probe telemetry. Each thread records into its own histograms,
+// registered on first use and kept after the thread exits; summarize()
+// merges them.
+class ProbeTelemetry
+{
+public:
+    static void record(ProbePhase phase, uint64_t nanoseconds);
+    static void count(ProbePhase phase, bool hit);
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    static void reset();
+    static vector<PhaseSummary> summarize();
+    static string toJson(const vector<PhaseSummary>& summaries);
+};
+
+// Times one phase of a probe; setHit() also counts a hit or miss for it.
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(ProbePhase phase);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void setHit(bool hit);
+
+private:
+    ProbePhase phase;
+    chrono::steady_clock::time_point start;
+    bool active;
+    int8_t outcome; // -1 not counted, 0 miss, 1 hit
+};
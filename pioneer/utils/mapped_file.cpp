@@ -0,0 +1,219 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+MappedFile::MappedFile() : base(nullptr), length(0), copied(false), hugePages(HUGE_PAGES_OFF), fileHandle(nullptr), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile() : base(nullptr), length(0), copied(false), hugePages(HUGE_PAGES_OFF) {}
+
+static bool readAll(int fd, char* out, size_t size)
+{
+    size_t done = 0;
+
+    while (done < size)
+    {
+        ssize_t got = pread(fd, out + done, size - done, static_cast<off_t>(done));
+
+        if (got <= 0)
+        {
+            return false;
+        }
+
+        done += static_cast<size_t>(got);
+    }
+
+    return true;
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const string& path, HugePages _hugePages)
+{
+    close();
+    hugePages = _hugePages;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+
+    if (length == 0)
+    {
+        base = "";
+        return true;
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    base = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(st.st_size);
+
+    if (length == 0)
+    {
+        ::close(fd);
+        base = "";
+        return true;
+    }
+
+#ifdef MAP_HUGETLB
+    if (hugePages == HUGE_PAGES_EXPLICIT)
+    {
+        char* copy = mapAnonymous(length, hugePages);
+
+        if (copy != nullptr && readAll(fd, copy, length))
+        {
+            ::close(fd);
+            base = copy;
+            copied = true;
+            return true;
+        }
+
+        if (copy != nullptr)
+        {
+            unmapAnonymous(copy, length, hugePages);
+        }
+    }
+#endif
+
+    void* ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    base = ptr == MAP_FAILED ? nullptr : static_cast<const char*>(ptr);
+
+    // File-backed huge pages need kernel support for read-only file THP
+    if (hugePages != HUGE_PAGES_OFF)
+    {
+        adviseHugePages(base, length);
+    }
+#endif
+
+    if (base == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (base != nullptr && length > 0)
+    {
+        UnmapViewOfFile(base);
+    }
+
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+
+    if (fileHandle != nullptr)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (base != nullptr && length > 0 && copied)
+    {
+        unmapAnonymous(const_cast<char*>(base), length, hugePages);
+    }
+    else if (base != nullptr && length > 0)
+    {
+        munmap(const_cast<char*>(base), length);
+    }
+#endif
+
+    base = nullptr;
+    length = 0;
+    copied = false;
+}
+
+void MappedFile::adviseSequential() const
+{
+#ifndef _WIN32
+    if (base != nullptr && length > 0)
+    {
+        madvise(const_cast<char*>(base), length, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::adviseRandom() const
+{
+#ifndef _WIN32
+    if (base != nullptr && length > 0)
+    {
+        madvise(const_cast<char*>(base), length, MADV_RANDOM);
+    }
+#endif
+}
+
+void MappedFile::prefault() const
+{
+    prefaultPages(base, length);
+}
+
+bool MappedFile::lock() const
+{
+    return lockPages(base, length);
+}
+
+const char* MappedFile::data() const
+{
+    return base;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+bool MappedFile::isOpen() const
+{
+    return base != nullptr;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "pages.h"
+
+using namespace std;
+
+// Read-only memory mapping of a whole file. With explicit huge pages the
+// file is read into anonymous huge-page memory instead, since hugetlb pages
+// cannot back a regular file.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path, HugePages hugePages = HUGE_PAGES_OFF);
+    void close();
+    void adviseSequential() const;
+    void adviseRandom() const;
+    void prefault() const;
+    bool lock() const;
+
+    const char* data() const;
+    size_t size() const;
+    bool isOpen() const;
+
+private:
+    const char* base;
+    size_t length;
+    bool copied;
+    HugePages hugePages;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
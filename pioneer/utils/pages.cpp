@@ -0,0 +1,127 @@
+#include "pages.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+constexpr size_t TOUCH_STRIDE = 4096;
+
+size_t mappingSize(size_t size, HugePages hugePages)
+{
+    if (hugePages == HUGE_PAGES_OFF)
+    {
+        return size;
+    }
+
+    return (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+char* mapAnonymous(size_t size, HugePages hugePages)
+{
+    size = mappingSize(size, hugePages);
+
+#ifdef _WIN32
+    // Large pages need SeLockMemoryPrivilege; plain pages are always used
+    return static_cast<char*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+#ifdef MAP_HUGETLB
+    if (hugePages == HUGE_PAGES_EXPLICIT)
+    {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr != MAP_FAILED)
+        {
+            return static_cast<char*>(ptr);
+        }
+    }
+#endif
+
+    if (hugePages == HUGE_PAGES_OFF)
+    {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : static_cast<char*>(ptr);
+    }
+
+    // Over-map by one huge page and trim both ends so the range is aligned,
+    // otherwise the kernel can only back its interior with huge pages
+    void* ptr = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    char* raw = static_cast<char*>(ptr);
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+
+    if (aligned > raw)
+    {
+        munmap(raw, aligned - raw);
+    }
+
+    if (raw + HUGE_PAGE_SIZE > aligned)
+    {
+        munmap(aligned + size, raw + HUGE_PAGE_SIZE - aligned);
+    }
+
+    adviseHugePages(aligned, size);
+    return aligned;
+#endif
+}
+
+void unmapAnonymous(char* ptr, size_t size, HugePages hugePages)
+{
+#ifdef _WIN32
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, mappingSize(size, hugePages));
+#endif
+}
+
+void adviseHugePages(const char* data, size_t size)
+{
+#if !defined(_WIN32) && defined(MADV_HUGEPAGE)
+    if (data != nullptr && size > 0)
+    {
+        madvise(const_cast<char*>(data), size, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+void prefaultPages(const char* data, size_t size)
+{
+    if (data == nullptr || size == 0)
+    {
+        return;
+    }
+
+#ifndef _WIN32
+    madvise(const_cast<char*>(data), size, MADV_WILLNEED);
+#endif
+
+    volatile char sink = 0;
+
+    for (size_t offset = 0; offset < size; offset += TOUCH_STRIDE)
+    {
+        sink = sink + data[offset];
+    }
+
+    sink = sink + data[size - 1];
+}
+
+bool lockPages(const char* data, size_t size)
+{
+    if (data == nullptr || size == 0)
+    {
+        return true;
+    }
+
+#ifdef _WIN32
+    return VirtualLock(const_cast<char*>(data), size) != 0;
+#else
+    return mlock(data, size) == 0;
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Page backing for the book table and mapped book files.
+enum HugePages : uint8_t
+{
+    HUGE_PAGES_OFF,
+    HUGE_PAGES_TRANSPARENT, // madvise(MADV_HUGEPAGE), promoted by the kernel when it can
+    HUGE_PAGES_EXPLICIT     // MAP_HUGETLB from the reserved pool, transparent when the pool is empty
+};
+
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+// Length actually mapped for a request of 'size' bytes
+size_t mappingSize(size_t size, HugePages hugePages);
+
+// Anonymous read-write memory of mappingSize(size) bytes, huge-page aligned
+// when huge pages are asked for; nullptr on failure.
+char* mapAnonymous(size_t size, HugePages hugePages);
+void unmapAnonymous(char* ptr, size_t size, HugePages hugePages);
+
+void adviseHugePages(const char* data, size_t size);
+
+// Faults every page in by touching it, after asking for read-ahead
+void prefaultPages(const char* data, size_t size);
+
+// mlock; false when the memlock limit is too low or the platform refuses
+bool lockPages(const char* data, size_t size);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// LEB128: 7 payload bits per byte, high bit set on all but the last byte.
+inline void putVarint(vector<char>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<char>(value));
+}
+
+// Returns the byte after the value, or nullptr if it runs past 'end'.
+inline const char* getVarint(const char* in, const char* end, uint64_t& value)
+{
+    value = 0;
+
+    for (unsigned shift = 0; in < end && shift < 64; shift += 7)
+    {
+        uint8_t byte = static_cast<uint8_t>(*in++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+        {
+            return in;
+        }
+    }
+
+    return nullptr;
+}
@@ -1,73 +1,79 @@
 #include "zobrist.h"
 
+// Generated with splitmix64 from seed 0x70696f6e65657221; all 769 values
+// are distinct.
 uint64_t zobristTable[64][12] =
 {
-	{ 0x9986d1e149050eab, 0x74efb0db35b6b414, 0xf0476f723ef276cf, 0xe0d68a6a9cd56694, 0xdcbb44afe562a205, 0x6a6a10314f75a291, 0xf5dcef8a419ea990, 0x7e9a93f31d843cfc, 0x31ad77bd84c074f0, 0xcbeefa2d0919471a, 0x3d1253a6506f772c, 0xc31e9f7057a9ae7f },
-	{ 0x9c754441b45bcf06, 0x5b5f2d4830d078ec, 0xf1c2f2f43d718b5d, 0x418f1cc0f717dbc9, 0x4fed24f2c459037b, 0x15206f36f60c0aa6, 0x85d609ead48b6bbd, 0x7dff37c636960afa, 0x544602a9c39f7cbf, 0xe7d90361e1a7215f, 0xcc0d64780648bb7a, 0xd12c4eed3aec2532 },
-	{ 0x83358ab7f5ef22dd, 0xfd10fae0e4962f7d, 0x3841c7de160b4f88, 0x2c1b5f3d7ffd349a, 0x94b28b9ee674e242, 0x4c536ad5692c159d, 0x87e0f7c15fa0bae6, 0x272ae35ac821c08b, 0x9b88a87a8b9ea26, 0xcbb575a7fb17de66, 0xb5a49bd3f9bde925, 0xc0a20a5abf4a79f9 },
-	{ 0xb8c62d1c76cab327, 0xfc03bafb2afe457f, 0x49e6e7937f7b5fcf, 0xa4faa7eecb4d3ed6, 0x3d8e5a6f61177f9c, 0xcbd23aeac28a1e1, 0x7190c1e4da6229d2, 0x3691c294e4e580d6, 0xba4253f24bc103e0, 0x4e192421e559a063, 0x3acc3a0469245b42, 0x8dd2633f2970f2e6 },
-	{ 0xc68d015903a9303, 0xcce28fb197f0cedd, 0x5202da1072fefa28, 0x1626516f52396a76, 0x35f21beca1342f7b, 0x869d986f3c542b21, 0xc6739e829b8dc203, 0xe17b42f48614944c, 0x7bbfe896cd3699c, 0x22aa3a679a135fa4, 0xa3e5c44a428b495f, 0x1e512ad166d261ce },
-	{ 0xc4388beda902f8c4, 0x58e3212048111870, 0x62f4d3f79b728881, 0xc34b1b0d117740f, 0x4cdd7631b1fc559, 0x3353cbe2cd5c053, 0x4f4e9b459ee6fb02, 0x99b2e62ec15d115f, 0xf21b303baa418e33, 0x735bdf764685de28, 0xdd29ec5c02851cea, 0xb4e519f41c1a47b },
-	{ 0xf11e3338cc74b69, 0xe04629dfe9110346, 0x6612e1bda6b3e98b, 0xcb49021f11bb2503, 0xe525edf20bd396b0, 0xf78c0ca7ef345a05, 0x7d53e52769bdbf0f, 0x73a253cfa94a8708, 0xc3550b0375200932, 0xf96eeeb74de80c36, 0x53fd19c6f13d6bc1, 0xcf17d0763f773834 },
-	{ 0x25b88479aa5baacb, 0x8765d024e962c846, 0xf1c804cb13e9fceb, 0x63e54be7e65979ba, 0x663d6453dbaaf344, 0xc3020f847e94800b, 0x418f9e2219d1098f, 0x359a3245f20fc7ff, 0x16d1f76738a3fe6c, 0x3d1c579cad317780, 0x3032bde858cc4ae, 0x22a3f83d537f2ba5 },
-	{ 0xfdce98ea5c5ec596, 0xc6d2e14bf2ae9bf2, 0x608cbaa327f7d274, 0xffec446611f30fd5, 0xc823fdd688b2d216, 0x6eb47097de3fbceb, 0x3dc2911bf48144e2, 0x36622e86f9983684, 0x1727933e5ccebaf4, 0x351cfa40fa29b096, 0xf38dff1493144b9b, 0x4f7361d3d964eeef },
-	{ 0xee4ab1e7b2a00bcc, 0x10291a45ccc25f1c, 0xd407cd50efc70b1e, 0x449d2643980133d5, 0x8ac77f8544fda7ce, 0x95826458f070a457, 0x7ed96f263240cacf, 0xd895063f99d29e54, 0x96fc343f8c94c88, 0xeec117b03ed93ec6, 0x17a474712d57ff51, 0x22a5189167121638 },
-	{ 0xdd2b88005ff288e3, 0x498ed9a4b2eb01a8, 0x8eb442f879320809, 0x96983e92464bb3d2, 0xdf5a771baae41b1, 0xa2282b3fc307ccb, 0x73f82e0b1b7b5a4d, 0xa10b0c456e85e791, 0xdcabcbf1ae11db7f, 0x5471d15f93849bc3, 0xf8e0d4878afb6143, 0x1bd12e96682d4fbc },
-	{ 0x89912404ef906ea3, 0x808ae5d88f30180f, 0x362487dd498a1937, 0xb14c17a4ce984ebb, 0x43ddc204f39281b1, 0x486f5fd8251e8fd8, 0xcbf025004920afcb, 0xfd87de41ccf06d0c, 0x1b1ad93277fde42, 0xda0d36cc7f4b8bcf, 0x4fe2d1b08be7d0b5, 0x6dfbe2e42c42e49e },
-	{ 0xdb7ac1653fbd7c23, 0xbf86fbd8e18a9c32, 0xb37a5195c5d05e7e, 0x1ddcd87181d9b05, 0xf4c816edfddac54d, 0x3f73d0737bbdc47, 0x7e2ac738f384dd27, 0x98fa3b22b4c708b1, 0xa214aabf3ec71de0, 0x411d03fd15777589, 0xd097e5ce148889cc, 0xce533f4435a2dc8a },
-	{ 0xe5b9f7a251e293cf, 0xa664c3f281f1f2a9, 0xb10217a6e24b0a90, 0xe933974223570829, 0xaafc1c1293641ac3, 0x22291194cbf1c074, 0x57d2c70cbf08e959, 0xaad3ee4de021954a, 0x42e002b162ee8d7e, 0xcf6054a4699e5709, 0x4ed08d4645bd640a, 0xf7effe2487d5ccc6 },
-	{ 0xe204012fe91b177f, 0x326e33efc65047b9, 0x70b4f73882972cc3, 0x491c25a836cf7170, 0x9d9a38803518e4f6, 0x1491682e59273455, 0x3154190da2ee2ae1, 0xe9fe896d8a6e4158, 0x3bea708d4cd5aeaf, 0x7571f857f6aae5bd, 0xa3673ee6fc1facbe, 0x3d80d9f2f58825b5 },
-	{ 0xe5c573f17422d1ab, 0xe5b1c4c63b40524c, 0x72ce379cbc008702, 0x88583a62a19f0cc0, 0xf28b7cb4e352b3b9, 0x6754f6e7fc467536, 0xec0129634f517cb3, 0x8f109dec12f9d7f2, 0x6a6f69ca40ef2991, 0x8b8edcca22b9f95f, 0x2ce74379e1a07c0f, 0xcdcff2a4114808 },
-	{ 0xc592b17368647927, 0xb695aac790d20821, 0xe967d372da5bd636, 0x5ad7b0031049bd42, 0x69b4239a6ec0afc, 0x905eedbb37fd8402, 0xa22cbb3fe047d027, 0xee8c7ee83c7d0643, 0xa2028413bd4836a6, 0x819c8d48b83f4d32, 0xcdb617d7ab9a76a9, 0x5ea6ae7142db2099 },
-	{ 0x9e5e2c135e56d84d, 0x330b77e9047eaf51, 0xfd5ba9a5671562e0, 0x4b3917bd081879c6, 0xd071a2410fe0b25e, 0xf2783051df2aeb0, 0xa5e9d65988f4437e, 0x717060e43cf1c7a7, 0xe1fe7570047b701a, 0xd60f78580c975690, 0x40946ff8d6d19c25, 0xcefc190efbea6ec4 },
-	{ 0x7b2af36e7e3394fa, 0xee1424963f4ab42b, 0xadc2e6842bbed925, 0x11f70110614ce7e7, 0x572ce9b110ade72b, 0x727c6f7fd405bc8a, 0xea9b7835b58a0752, 0xd0982a551d58d53a, 0x116fd2863c92c3f, 0x2bba4ebd22c39730, 0x2e4e58e27be6512, 0xa19c1500924cedec },
-	{ 0xab513b9370329150, 0xe1ed29481ec2256b, 0x6b7a10ea9df16ef0, 0xff3f86dbc14bf32b, 0x5b257dc9bb4b363, 0x5d4bafbd39051c2e, 0x3255d5094c16d471, 0x8c6f5914cbf0b05b, 0x40ec9cfdcc228bdf, 0x836ac5b45316a37b, 0xe8f17884846734e8, 0xae429f4529a06d27 },
-	{ 0xcd645e1a98edc642, 0x41431e0268e0b052, 0xad2b380bf5861ab0, 0xaff6d31ca57cdfda, 0x75b50f84427259af, 0x7a07fd08e4cb719e, 0x4381ad04b32292d1, 0xdd01d0aa49d13dc2, 0x6729f7a7f3e39993, 0xcd5825801df61130, 0x338c3143522e8f59, 0x2c62c5b73e3f3de0 },
-	{ 0xcc9c97d2a066c446, 0x97cb9b840a7ab628, 0xcdaa3f79af8e949a, 0xe9153d80b69d69ff, 0xa39cffd0265ff746, 0xb6ea5367c69b5055, 0xde537c84aa73109a, 0xb141645091f4ebed, 0x66a61a17fd802fa8, 0xc8078e268e9924cf, 0x43be183be39548ff, 0x2b39f3ca67cf95bc },
-	{ 0xa0c33ede32ab52ea, 0xa9cccd81cbc41f31, 0x41592bea16bd6e51, 0xb0a12657dfbb3db9, 0x97d1f0a391757860, 0xe62580a2fd894f3f, 0x1ca395389fb82e0a, 0xfda97297efbaa951, 0x6e3881826e7ca81b, 0xa6f6219213c76fbe, 0x5955e0be48c0637f, 0x4f7c6a5f91446b68 },
-	{ 0x288ba4f339637b6b, 0xd7652e762cae7983, 0x39ca39203206d4c0, 0x3007a7b6bd0f2901, 0x4afeb638d736f640, 0xae4c4e9ae8725c17, 0xaa5261c417a5881a, 0xd8df2b862a6d04a7, 0xcd692706917f6b0e, 0x45db0c3bec4d294f, 0xa116d6ba0af61aee, 0xd3026312057c9c30 },
-	{ 0xebf2364c433597af, 0x3b208ef1535e1b3c, 0xcf884dbc6b7b9e2c, 0xb90e70095dd674d4, 0x6e564dc69a404a5a, 0xd56bd9fe23705693, 0xfd54679a0cf493c7, 0xdea2363aec838aeb, 0x8409f1b1c3174ab0, 0x76d92a64f018aea, 0x55a04cd5ddc43f1f, 0xd92d85df5f386f57 },
-	{ 0x444b5c6263c76514, 0xec902783be3b55f3, 0x765cc2d515431d95, 0x3434b2b222d92443, 0x8b06fe15b327f2ec, 0x462e16be5eb4cfcf, 0xd565282262ce06b4, 0x8ea0afcb56299ae9, 0xcf228e7c3ce1dbde, 0x7ea2b1c281702210, 0x78e558690a25d26d, 0xafffbcce4f0bee8b },
-	{ 0xce4bdc942ca12c5a, 0xa35d710ec0898a51, 0x71593027d1fb9268, 0x9464b199fdb14e7b, 0x239f1687ceaeb9fa, 0x10d12cbe282d581f, 0x4aa60687caa9a682, 0xf747d3b620520f34, 0xd9e4c1a4bc1ba77a, 0x7e8a6d532c55d5d2, 0xfc00c16ab447daac, 0xa327c68bfce475ed },
-	{ 0x9085119b61b02501, 0xb7ea729719d658d2, 0xba52c149cda2434, 0x72c93d30bd05ad51, 0x7db3aad3b39cd688, 0x7f343562e3a1e4d7, 0x56bc8d56965f3753, 0x84b2cffa6dab5c11, 0x77a80c52d133bfda, 0x3a4941a72f54dcc7, 0xf89634fe800c2f75, 0xf3ea908ca508cd92 },
-	{ 0xdab04fecf86ee874, 0x10a21c15be613da5, 0xdd6f80ac6acd191, 0x6028dc33471e842f, 0x4600dbf7739bd7de, 0xb078e54bfd9e437d, 0xee2628a7f8e56be7, 0x229ecf721e2239f1, 0x1213b471c5c6847, 0xeeb32f76d7b32dc2, 0xeb42d6e45e755fad, 0xf7aac923a3f0dbb7 },
-	{ 0x70d08fda542ed2de, 0x2d800f13db9db042, 0x2a9b5638e3f77a4a, 0x51a0976c38dce962, 0x451496e8811ea1ac, 0xedf0c38cb2bfaf97, 0x403b18ef6f2b2038, 0x8c4adea96b20034a, 0xe53b4310c96794a, 0xaf793ec3f450ef3d, 0x4c020af51cbef90b, 0x9e8010b1dbce729 },
-	{ 0xf0c2dbd7fa0b0696, 0x6f763936f85634c5, 0x67ff16fee9e64b92, 0xbfe9da8ba5a585f5, 0xfad35502f220f05b, 0x977e2ccf6a945718, 0xdbceaaa7119b780d, 0x2d285036cf3e96fb, 0x9c40ecc41c79131, 0xac208f7e82cf5772, 0xfe962a06187c4b61, 0x2e4a7b4e87b13ea },
-	{ 0x8264a27a519acf8e, 0x5c11b0eb5a2b544f, 0x3acab97ebeae1930, 0xf4401c0c5010fc3d, 0x9bde168b30732ea9, 0xaa0e165e28f551c0, 0x2ff523f0fd2c9d27, 0xf74a59f47de5882a, 0x637c6045d06451f2, 0xdf6dd503fd8cbccc, 0x42199a1ef4a5953c, 0x5e4dbe5bb58439a5 },
-	{ 0xeef984c1f767876, 0x115bab48a77b1d44, 0xc41c66f74797dbb5, 0xe91f45633cec5b7b, 0xbc69f58ea99b3a10, 0xac9dd4a451bb244c, 0xced73be2f5bb1b7, 0x83daee0a9d7f72a3, 0xe3f8601ac6883bd2, 0x7556c1d65639ef4f, 0xedf64b8bae89b0b0, 0x9f355f50e013e014 },
-	{ 0xedbe9c9599f94e65, 0xad32691c17ef68bd, 0x60ef7638f9a33a28, 0xfc75f950aee30fb3, 0x8f6598e171272958, 0xe3bb64b12b97c6dc, 0x65796342c58fcab3, 0x659374b44e37e4e5, 0x16dfc9cae236d36, 0xfa9f71cb5669a634, 0xbb09b3b03b8f5df6, 0x9d42ec608af1385 },
-	{ 0x8ff7609315a89f60, 0xe776ee2cdc899646, 0xe5526dea55c861c8, 0x46616d6b03a4eb1a, 0x221339e69f7eec0d, 0x7ee5ae3dedbe24af, 0xdb8d706fbcc7c0fd, 0xdde7289fb6f3b05d, 0x657522ef26020079, 0xb36d4598ed4c4be6, 0x5ad65a45d99d5688, 0x9d9773d0ea5ea565 },
-	{ 0xfadb8ec3c7688192, 0x717c9c478ee7113d, 0xb555f0b3758f68bf, 0x57c8d7677be57221, 0x97de71121b11a30e, 0xfaec4f2650aaef87, 0x11caea112f03788e, 0xb4fb1ef58353e580, 0xa8464af72bcd5747, 0xed2b9f50be062d01, 0x631b302c7afe895a, 0x6f3870e0c38f9c75 },
-	{ 0x80e9f513fe4671d3, 0xf4845a7643cc1ffe, 0xa747e37f132463b7, 0xae597a6fee56dcb7, 0x2a8d30541c44ff34, 0xfffba81a1d555083, 0xce3d4a7913c3e039, 0x886e59ed3210d2f, 0x263a49c69db13675, 0xf7c3ee68d091c747, 0xf6ca06969d9cea47, 0xe149a4bca5968f7b },
-	{ 0x23c6d7e2d87c35d6, 0xdc61cc6411ac2189, 0xb217a059980ab2d9, 0x987a028286802eae, 0x634aba8dfeb31587, 0x9d2b3a6dad2f711c, 0x1f0f36e614750aa3, 0x5d198cbbd1d994db, 0x6f066167c7d694fc, 0xe4ef5c4fde09fef, 0xede3846c92de4aad, 0x3d8d4712c2dcb4e6 },
-	{ 0x2a4372c180d0d14e, 0xd6ee2dee156e519b, 0x8548623406c1a193, 0x12e1c81caac471da, 0x9fbd74307541b14b, 0xf2322f73af38e833, 0xe8464e740a03d1b7, 0xe500c69fd37a7b23, 0x63ca72cdfbfd2ffc, 0xd709cbdeffc58ce1, 0xbe31698cc18f07fb, 0x5980f6c0fbf0a12d },
-	{ 0xd5a33b73cecd1bc, 0x9bec105ca28d4da4, 0x6d4674062721da1e, 0x4c42f6b989947536, 0xa74410d369c2c4da, 0xe0d367ad842c3e3c, 0x93b37d5484af93b0, 0x4b8fade35d141edb, 0x922e2269d1971220, 0x5d68cd3287db6f70, 0xbb872c4c6c7ad618, 0x4b889455eec353c6 },
-	{ 0x6517ae27d7b7dcee, 0xb4d0e68e409009e2, 0x4952cb348bb13e9b, 0x6dfe4ed9bacfc8f2, 0xce658e630fa8603a, 0xe6be22a34e6197d9, 0xd273c2319c5d2e11, 0x8b057b5e699d75c8, 0xfcaa9ed8986f4665, 0xfaf899976398abbf, 0x73c98beddcb8a18d, 0x3a7017288e1585d8 },
-	{ 0xef54ae9f7aa45ee, 0x7999fa452dd0f907, 0x70aa04165957c7d1, 0x812061e2024ef371, 0x73f3d1a2ef8114f3, 0x21026cd1419982b7, 0x79a1471d8e20dcc7, 0x3285e7eda46e0458, 0x89acd29396afbfb3, 0x7d95c1a9377a25ae, 0xbea2ee0c26806714, 0x49a3015f12e14c9b },
-	{ 0xf4168efad246f496, 0xf72defebb7f07831, 0x293b7827823e3177, 0x8aaed9da51e83622, 0x90e265964b468628, 0xa12db9cb1c0ea701, 0xb4de91df33225aa1, 0xf4a79dda5aabd3d6, 0x36ee202750bffdec, 0x382124fe91c0dd6a, 0x952358a64fdd435b, 0xebbd079abd765bee },
-	{ 0xdbeb87353672c60b, 0xe1a2aa0446d4a930, 0x334ff29d899bdc51, 0x1026664f0bc866ae, 0xdc52d615ca04519d, 0x3492d74f6c49138e, 0x94af64c2c8f6334b, 0x81fb780fff772f39, 0xe65235fdccf1f58c, 0x1b105d9e3a075516, 0xab09c5d4ddf1b9f9, 0x90ae8695d7b59d71 },
-	{ 0x9986d1e149050eab, 0x74efb0db35b6b414, 0xf0476f723ef276cf, 0xe0d68a6a9cd56694, 0xdcbb44afe562a205, 0x6a6a10314f75a291, 0xf5dcef8a419ea990, 0x7e9a93f31d843cfc, 0x31ad77bd84c074f0, 0xcbeefa2d0919471a, 0x3d1253a6506f772c, 0xc31e9f7057a9ae7f },
-	{ 0x9c754441b45bcf06, 0x5b5f2d4830d078ec, 0xf1c2f2f43d718b5d, 0x418f1cc0f717dbc9, 0x4fed24f2c459037b, 0x15206f36f60c0aa6, 0x85d609ead48b6bbd, 0x7dff37c636960afa, 0x544602a9c39f7cbf, 0xe7d90361e1a7215f, 0xcc0d64780648bb7a, 0xd12c4eed3aec2532 },
-	{ 0x83358ab7f5ef22dd, 0xfd10fae0e4962f7d, 0x3841c7de160b4f88, 0x2c1b5f3d7ffd349a, 0x94b28b9ee674e242, 0x4c536ad5692c159d, 0x87e0f7c15fa0bae6, 0x272ae35ac821c08b, 0x9b88a87a8b9ea26, 0xcbb575a7fb17de66, 0xb5a49bd3f9bde925, 0xc0a20a5abf4a79f9 },
-	{ 0xb8c62d1c76cab327, 0xfc03bafb2afe457f, 0x49e6e7937f7b5fcf, 0xa4faa7eecb4d3ed6, 0x3d8e5a6f61177f9c, 0xcbd23aeac28a1e1, 0x7190c1e4da6229d2, 0x3691c294e4e580d6, 0xba4253f24bc103e0, 0x4e192421e559a063, 0x3acc3a0469245b42, 0x8dd2633f2970f2e6 },
-	{ 0xc68d015903a9303, 0xcce28fb197f0cedd, 0x5202da1072fefa28, 0x1626516f52396a76, 0x35f21beca1342f7b, 0x869d986f3c542b21, 0xc6739e829b8dc203, 0xe17b42f48614944c, 0x7bbfe896cd3699c, 0x22aa3a679a135fa4, 0xa3e5c44a428b495f, 0x1e512ad166d261ce },
-	{ 0xf81daa8ab5e8cd7f, 0x9f8011d7f6468875, 0x8cfe9a8dc3388b7f, 0x5c6752cce2f5afb7, 0x1015088e4cd3fa2a, 0xa8a5357049a8fff9, 0xfbfb7e1bfe9991aa, 0x4a2fc043758d0d38, 0xe94b962538f1698b, 0x3e52fcc16efd928a, 0xe8bb143e1a6f33b0, 0xc9216a23ece5fb8b },
-	{ 0x373e06068cf35a2c, 0xbf51dbfb48b66a1f, 0xdf0c48f196e05888, 0xdb94ed998c41aaf9, 0xabba1f9829ea0fd9, 0x3b1494b16cd2eae6, 0xc89b7c3a07064640, 0x48934c1c6d3b3e9e, 0xdee5cde84e83cb0a, 0x1bdd3b30e558fe07, 0x9099a5ae1f8636, 0x2622a94e2c5027da },
-	{ 0x59671361250bc156, 0xc899affb8d04cec2, 0x8681ef1e110c56bc, 0xec5c5ff8233b9903, 0x84649f0875b3077e, 0xe7de61eef09e3d9a, 0xab74fe0dc2018e0f, 0x13d59aae08357eb9, 0xec9915001638be5a, 0x522809ff332baff9, 0xe9daf07272c341e2, 0xfb762408a07bcb7 },
-	{ 0x3fdbb44ae0c97d31, 0x6f4c3783a9143703, 0x97b16eef88f8e1e4, 0x9f6100ebb0252327, 0xb9d71206511d2323, 0xe56039c4cda36a43, 0x75e63699a70ddc5e, 0x39c0fc4761820e38, 0xad2616e9b465bf15, 0x9cf53bfb2e12cefe, 0xf37cde8c5acf298a, 0x8e988e0cb4a32f2 },
-	{ 0x184c3f790450bcc7, 0x32488c3d2ffb377c, 0xb62a3ce7e9db6277, 0x48d83caa0a460a4f, 0xae28707c7197cc89, 0xb38ef5351e2d76b1, 0xe672d5af7fca1835, 0x33d074aeed08cf7, 0xcb8ec1d6851b35ca, 0x534acd384b43edbb, 0xd617cc3dcb160f9e, 0x3226e419c0caeb22 },
-	{ 0xdbb3cdf7f610c9c6, 0x6d358c3a35effd73, 0xab5feeba326732a9, 0x91c52c1a170e699f, 0xe6ff7c50e74e8031, 0xfcaaa13764ae8346, 0xcc4a5850ff7dbeaf, 0xea81ea6371e275ad, 0xf90bd6cb40565333, 0xeea19b7c86aaa046, 0x95ac75cc1c3bb41f, 0x4768e48df8923b9e },
-	{ 0x167e9fadf849f1d5, 0x1505ce1a83285aa8, 0xa8dbcb5b722882c6, 0xa7e6f4cf47fc5d92, 0x4c7cfdfd51f20c13, 0xb2e69f84fbfe220, 0xa3d81cd07d3e72d5, 0x69564a1c3e37a66a, 0x34af2aa2684c8662, 0xe3292f08a64c065e, 0xdee953b60628785b, 0x103b111584189267 },
-	{ 0x568dc58a20685d7d, 0x5d3533b8eb4c8b3, 0xbaba1dd415d5b05c, 0x2d22292eec8a54f2, 0xef556aa94324772e, 0x6c2a0f90f6e8bca3, 0x55619453dffc1e76, 0xf66506df60af1d46, 0xa79528dd3531abe6, 0xaccd9a7ad1435da1, 0xe9a973eba8ad6d6f, 0x44e8a126df40b5a9 },
-	{ 0xe258689cb562803b, 0x336e68598b42f08c, 0x4b8af0581ef4c92e, 0x9b5a623714c1502a, 0x1347defda263c12a, 0x5675a120f1bba564, 0x9044eeec4c06ac60, 0x2efcf97fd6a03526, 0x5c884535c877c31b, 0x4a90a222ed68e4d7, 0x83993a9d536e1320, 0x6f31a524eb0cc33d },
-	{ 0x83d06e7ee441ab9c, 0x764fe8493de6bd8c, 0x48f2cdba401dc4d4, 0x1edfc3a9bfa994ad, 0xbd59e04ef16752e0, 0xbf1a24db32ddbb99, 0x229b81d5df5590c8, 0x3f8b937a5bf5b932, 0xc334d532a5adcb94, 0xbe1ecef3c27366fd, 0x46914174d227608f, 0x1a8851fafa7c90f2 },
-	{ 0xc628865ed2f8fae6, 0x19fc3f531269b010, 0xa8bc6bdea21e1cc, 0x10417cac596a4f55, 0xc2925017f5babc6f, 0xaa1df3d4a7f7021d, 0x4f2cd223f96ab578, 0x627806cc5830eb9f, 0xb8f595a9c9087656, 0x34e2e219a82faf73, 0xbd6ad951c4b2a595, 0x503625f513874f9a },
-	{ 0x5115eba1c978c1da, 0x70b7c60737360190, 0x84c4512bbcf1e77a, 0x2f2732008210ded5, 0x6434b333637067ed, 0x79bb8de66d722336, 0x551bb397b6b6c814, 0x496b50e1b274ec96, 0x37581c80226e8c65, 0x312d41c9e1dffd97, 0x893e4f8b3bd0d39e, 0x9aeb4ae74a299ade },
-	{ 0x75d919611913e372, 0xdbb8e8de30217bbc, 0xcb91eef5cfea263d, 0x4a47897fbac4e2c9, 0xe25679eabe942312, 0xdaa8ce11fdb17f96, 0xb8eb9f80a719ea34, 0x2b2a20dbacfca844, 0x40147b1f0de510c4, 0x68e301ccd6f2ff03, 0x804c1e79d2d8c7de, 0x5ecc75eb4cb5c96a },
-	{ 0x54dd0b43952765cb, 0x435e73b78a8e0fc4, 0x34349a95775c4591, 0x95b2e12bba5ac817, 0xe159dfaf06b5e94b, 0xb18a07cbf55f43cd, 0x663dd7fa0030c383, 0x54b06ceec3098877, 0x790b85e52192a857, 0xacad7316d5feae44, 0xdf35bc2ef1897fd0, 0x4fa4742d84c29c85 },
-	{ 0xf45d03891798ac92, 0xa383714a138a6308, 0xbe8f0b193506ce5b, 0xa7a354d1217c6639, 0xed05f68bf1b2704e, 0x84642d5f2fe0cbda, 0xdc5a78a43d992f63, 0x8b0fd0d2bf00271c, 0xbbf41c672f1091c3, 0x7975ada9dd25bd13, 0xeea3e6df52a2c460, 0xa90e22083a0edb4b },
+	{ 0x01aec94dcf306d4c, 0x2359f4f729f638c2, 0x70bfe0b6ba6fe9da, 0xc8d88a5150ab7f31, 0x11383707a6496b29, 0x035006baa4a16771, 0xb064c05573c13080, 0xfe67aef463977098, 0x44f8895986911701, 0xfcae4f29fd361878, 0x068afa043bd6f331, 0xb32501bf1c3d7fc7 },
+	{ 0x2033e3ad45eb803b, 0x3454369c4e2f72dc, 0x4b1b6c4e29a8dae2, 0x354ce398703f77ee, 0x0ef0fc7b3174455c, 0x558bf4a895102020, 0x291c4c73ec7349c2, 0x3ab986f462c8ed94, 0x896de2e3d7ba88b1, 0xb774c46dc09a9b16, 0x00d69149a0a0c0dc, 0xaa966e6853bcc21a },
+	{ 0xa3a6ce74cbbc201d, 0x47f8ea862080d84f, 0x05a405102928b3b5, 0xf25ffcdd5f4887fe, 0x4f841748779b6e18, 0x499835bce66dcd0b, 0x44166aa8c86f2705, 0xc00df4b2a71400da, 0x3acf2c2d6fbcb9b4, 0x5c2ef6bb55a01cee, 0x89a00fcfebe1dd9d, 0x326cbe0efad722fd },
+	{ 0x3f7df4156c3e7e8b, 0x3e8d3106181972a0, 0x25c54eb1a6de991f, 0x92fe57789a671917, 0x7805bf0e187d5937, 0x136fdb708b2da76c, 0x819a2ee60e2838ca, 0x5383179440635474, 0xd01cc566edad1f8e, 0x2a99c924e2142ad0, 0xda1704e78761c87b, 0x85a91cbcbf530ef7 },
+	{ 0xba0495d2ac67c8ee, 0x1182bced4d376848, 0x93dabeff41177f27, 0xa49065f31aded7cb, 0xfa4e5fd7c6f4ec38, 0xfce5d8aeb78c1d46, 0xf836ad20184c80d9, 0xe650ec94dac41be9, 0xc58569c6df98dea8, 0x8e356ec2016e1f37, 0xd1b4ab70336e6ea8, 0x6bff34375ecce807 },
+	{ 0x1cb15f1753b4cf8f, 0xf05de65665c2b338, 0x3ccb6aac5ad134dc, 0x61d80ff6d85b49ae, 0x476dc4af90f6b85a, 0xde07d04a0664d16e, 0x2ea9097637b268d1, 0x6ff5bdeed54c3b87, 0x79798071bfaec5a7, 0x2c4d373fcbd67689, 0x8b22d9abd994dc0c, 0x2f0a5d6dd3a4c0f6 },
+	{ 0x322c8510812ff27d, 0xa20de41d3c8bd634, 0xece6e9fe3eee3263, 0xdd02aa55005cd2b5, 0x57800cdbac477a42, 0x195842ada8cd01b9, 0x1724642431bda0fc, 0x7799c007aeeb067d, 0x50c850bb428cbe43, 0x63fba0f885bda59b, 0x4db9b4fd65327c7e, 0xc2bf5a0b1065a16e },
+	{ 0x8cb0bb77fd06c4ef, 0xd4ed7217b509afe9, 0x359bab1ebf350146, 0x30417edaecb4299b, 0x6cf13e1540683a34, 0x681452ad00ae85c1, 0x7bd720722c63b506, 0xfbb3e695ac778b35, 0x5856b425373e9ac6, 0x1f02196054418b6f, 0x81f201b19bf4867c, 0xe5dbfc647a3f0af2 },
+	{ 0x07c4a7fb4cb496f7, 0x4362f6360bcaa9b6, 0xe5582c6382978896, 0x16b79dd1524c1e4b, 0xfce8a05a5dbadd53, 0x3174c574d4c2cfcb, 0x93eec3ad876df318, 0x584bdad3c9023909, 0x42de1d097f4bd765, 0x220c70cd95b40620, 0xbeb96c531161d356, 0x7fef661c5d808edb },
+	{ 0x2e8b9bc55ac08d0f, 0x2777863c5833794e, 0xf6d1edbbc3a9618e, 0xc7b12a18d65d3821, 0x3b05b02cc6bb2d8a, 0xd73fdf79b490682e, 0x4d12139ac54467bc, 0x2da0f90d55f6cea8, 0xfffae4d9c5762365, 0xe38e0a365d5a9675, 0x8820d5e3cc5c5226, 0xc837a6702848ecc6 },
+	{ 0x8857c57a16232d2f, 0x41209952cf2936d3, 0xbd5b851a7c768b06, 0x0e473608cb6c0f5b, 0xea5c5683869663c2, 0xdd3e086a2c266d87, 0x9844edfcb0525b3e, 0xdd30e9a779b4e86f, 0xb0e0edda5bab40de, 0x24430e538080082d, 0x3d601ee116b6f13c, 0xde5439b787dbaec2 },
+	{ 0xed600606ef202496, 0x1804440f4e7cca8b, 0xfb75ebf01c2f5f13, 0x4cf46a1f32d0a111, 0x185bb30577eceb3c, 0x4f620fda7ba211a9, 0x36c43eadfa6d25d6, 0x708e8808c7c95079, 0x9ba01cfb26e4fd2b, 0x87179425435fcab8, 0x761b861594c56152, 0xce3723f2730587d0 },
+	{ 0xf775abbe35c48c98, 0x859b4d1699b6a9bd, 0xa5ced5d410dd9f4e, 0xacb4f6fcabe39b7f, 0x353c5af9b3a27f21, 0xdfe3aed6a2295032, 0x7723695ddea8c1a1, 0x9fb5f06d85fa9a08, 0x311859e0a2741295, 0x5129c49d19c910b9, 0x7b3fc7a3971ceae6, 0x0a5c1caad02a49a3 },
+	{ 0xffa6c928107d2e1e, 0xefdebfb388b7753c, 0x746e67e3eea16877, 0xd7b399e8a60e4ba3, 0x703347c008fa4826, 0x86f475b18d92bebd, 0x1939f1b00bed03ff, 0x5020bad13e1a589f, 0x690ec3e63489eb5d, 0xdfaddacfb36ff8cb, 0xd94a2210f1278aac, 0xbd1406671b614ded },
+	{ 0xbc8a6722849f5ba0, 0xcf276ad8f35d1b08, 0x2ed86953970197ac, 0x31b6aacd8d07d106, 0x30cd0ea51b274c01, 0x64324cd6a6aa8328, 0xb8227a53f6e96c69, 0x0a735a6c8c893287, 0xe2085ff8ce093a51, 0x707242738641974f, 0x65dad525fc04f667, 0x997d51b6c1aee38f },
+	{ 0xf28516d904b1d571, 0xe94fb21090057829, 0xf2078dafe46ed363, 0x5b293e39d9422ed2, 0x1080178f589e31b3, 0xaa617d01a9a39745, 0x7fee32d4067e55c3, 0x1dee7043d77184d0, 0x2497414546a31b36, 0x3b2a4243c45e6eb0, 0x1f00eb026bfdb504, 0xad2e5a30c95273da },
+	{ 0x9e86664672737dca, 0x37d246757a2a6fff, 0x3fe3d0becbbb85d0, 0xe2787067ac456083, 0xc377b223de21fbdf, 0x97de924c9cdefc49, 0x8163afb04c3ecaf3, 0x61421953426b190a, 0x9e30cfcd15314f63, 0x3dd5751243ab6843, 0x56e718ba5d27b27c, 0x60439fb64e4fbb3a },
+	{ 0x464b4e44433c6ac7, 0xe16d7fa14b55c1c4, 0xbb6501f02d58e228, 0x3b01c5b48bfa266e, 0xace2cbf8ea7a195b, 0xe87cbc61864be4f2, 0x2bdc441fa8edf71b, 0xec064138efa14883, 0x15bc4e51e2c26ac2, 0x2c2797c47e7503ca, 0x27576cfc5a418f3b, 0x1b55eab70e48dbc2 },
+	{ 0x278a36f1b77da421, 0xad3a62bd9c2ade19, 0x5d196d4a23b279a3, 0x6beeded9d1b97270, 0xbe31b2752682208d, 0x069d12754fdf4b15, 0x0ac1062738cafeb2, 0x1d5b57cf4f9bf129, 0xcf60fbb9b341acde, 0x3b13c0e103bc28ed, 0xe2358b54a0e4185e, 0xfbc7574be2596c89 },
+	{ 0x4b6bf0f2d4da1368, 0x5e8b90add1e584dc, 0xbb1ee87e84072083, 0x38201f3e5d7ced83, 0xe0c80135ca70e6fe, 0x6f7d93377e83b8ec, 0x8cf8f6be5e12dd80, 0x6776f91ab1232e0e, 0x29194ff95eb299a8, 0xc38ec1c9a1ececbc, 0xd26cd294b8e0d9ff, 0x943c3111e9f4576f },
+	{ 0x2f9fd2d965d5c728, 0xf014ec913b4a1664, 0x52d813e2d8d01ec8, 0x99ba0beaa54749fc, 0x8c511c1f5ccacd80, 0xbe5c3e3b64171ea9, 0x9ad338dec35cd8a2, 0xb71f97db9d732b08, 0x3be59cc665274415, 0x918d4d6e1c65dab5, 0xd330937cece66f4e, 0xe25535b555718f8a },
+	{ 0x0a2460aaec2bff7b, 0x16ac3c11c4df5459, 0x469f0bbc142a31bd, 0x34a4afc78de79df7, 0x249c0956a0c205d2, 0x36df39791e278e7c, 0x2e94e9955737c1af, 0x4745a48d021c31c7, 0x6fcb65c5eb1921c1, 0xa79b8cec4acfe0da, 0x1bbd5bc7552ae00e, 0xac14aa742dd9f041 },
+	{ 0x9af5b28a22ea26af, 0xef96cb35b4a05ee7, 0xcc8679f819975ae0, 0xe61fc7556ebea89c, 0x25cb4a53dacf0ba1, 0xefa2c468d287d7d3, 0x02556d676622e016, 0x826d77090503c381, 0xedc67c5795a6557f, 0xa0298f817a1d7e44, 0xe5f338febc41b95c, 0x9abba7d2ceec2d22 },
+	{ 0x150cd6d3b5f4f2fa, 0x22dc401f26933998, 0xb8f3c9174befa3da, 0x1b1b3cc1240f7918, 0xe86c97a373f4b456, 0x1ea6a8823252791c, 0x7b6648f2e9d34ee1, 0x610134453f25214e, 0xfa8ae6281a8f1d4f, 0x151bd369314b5268, 0x1f31e5d522cd3efc, 0xff0a1dee9473520f },
+	{ 0x3326f92ce02a7807, 0x13505687e1e1b949, 0x0a3dd8650fdd655a, 0xba64b78c843ee280, 0xdac94033dd605da6, 0x8ca6ea351f3e28c4, 0xdd47ac4f8cf27f0a, 0xcf6e8185ed572205, 0x5618d20258bb8268, 0x4703b3ed08147c30, 0x3c14f99bd51325cd, 0x9ed27cd6c8d4d26e },
+	{ 0x4134711b0427dec1, 0xab4deab40cee39ce, 0x93f03053307e021f, 0x32e909e4407cac2d, 0x9c90fdbf81842e4e, 0x47d38e9c74d6443a, 0xd36bf6762669cf88, 0x435524ef6fd45bff, 0x00e74b8f5a667162, 0x0068d9606e1328de, 0x249ed0dbdb9e9ec7, 0x6402441a594adfbb },
+	{ 0x4d86e751317bdd5d, 0x5c90375dbd6b18ce, 0xfecdcae93b8706f6, 0x3291161d355aaa5a, 0xbce531e9a79370a1, 0xb98962b3cd11f2c0, 0x48953a9feea89e8f, 0x26e9b6319cc9f9df, 0xf7b2b44ae550030a, 0x57ad00dccfdfddbe, 0x8fe18606aba06fb1, 0xd19441ada80964f9 },
+	{ 0x71b88ffe7134e2f0, 0x80dfa81d06bb30a8, 0x68075bfcbbb335cf, 0xf5a66cb5995caaa7, 0xc4f4119408b90e72, 0x9e8ad625e558684b, 0x71610fc32bc056c1, 0x6e33721249dccf84, 0xd8b7aa2f83cb95dc, 0xd7836fa82e9b5111, 0x13f6e9e6a4ba3167, 0xd314e50bfd25998f },
+	{ 0x681e65c60e552378, 0xaa948eed391bdaf6, 0xbbbf72c5056fa175, 0x63a7b83574e0bb73, 0x49ea6b0a0a0bed76, 0x0eec1e7d2174360f, 0x7393a4fd9146b2e0, 0x2a88069e4620f8e5, 0xf1e4fb1dc718dcfb, 0x03c7f1a6a4c9a57c, 0x13a123cbd5b86b16, 0xaf65ad72defc5e34 },
+	{ 0x0d79b67d2d10afb8, 0x047166194c268f6c, 0x3709a0589e7841e8, 0x97f5fc98b743dd6d, 0x84f1a423415faa81, 0x27ff8d1d7b3f8aa1, 0x07d854d7bd8649d1, 0x0696374aa8657fa0, 0x84193f994661874a, 0x0a243f5ba2f62197, 0x4593eb10ec53284b, 0x7197f149f9facb90 },
+	{ 0x0792598083fc800c, 0xf1633be28a557bd9, 0x50cca62eceba24b3, 0x58ee41667b8c15e4, 0x362b64cb6e4c6e9b, 0xdc460ab0b1573f13, 0xe5dfb706c482497e, 0x86ea12a229b74cf6, 0x3143e5029e039b1d, 0x30a3e86ce11dbdb6, 0xff0d9499d6041f54, 0x6c1b2b8e1a0a6d2e },
+	{ 0xbf7074a50cdbe7bb, 0x29c119f33df1cdc0, 0xefbddab20dd577ab, 0xa54841880e15213f, 0x0851b0164e84e4ba, 0xd17c807ee914c2e7, 0x603f56ea8eb8168b, 0x3436388e990bfdcb, 0x2dcc8e506dcb6830, 0xec625b2f138601a4, 0xb95cec3faa31668a, 0x3699593b55ec26de },
+	{ 0x4f5a5d462ae56d1a, 0x27b5d3e0e9e36bb2, 0x365e8f759bb5ec6a, 0x895dbc694624b55f, 0x7d51fe46a1084046, 0xafd47f44ddb6d4b5, 0xd4cf8a9a68c5ed0f, 0x4a8629a72b24002c, 0xd6f95107962c98c6, 0x99f1748c04a9a2a9, 0x0c8997c9aad0d68d, 0x1839a82c123da000 },
+	{ 0xb0acce846da5a54e, 0x31180aee1f8147be, 0x49a195eeac9e9127, 0xf6a2e65bbe0970c2, 0xa901ae4e40db5432, 0x7c66b0d0c451c8f7, 0x08d5be1df15f9879, 0xcbdf9f0164a4167d, 0xfbc31f904b1dc79a, 0x65454ee923b59925, 0xae1a67547be51d7e, 0x57ea9d004e251f3e },
+	{ 0x87bd88df9a2883ce, 0xb0361d76a53ae176, 0x2ae3cefb088489c6, 0x98736665a6159992, 0xa5e5fed7b7b6bc3c, 0xca1757d20065eba7, 0xf769683689dae2d5, 0xd3c085720511b206, 0x5c69357943503265, 0x453e40ce9a52fb10, 0xba197e9597f2f29f, 0x08a7aec5c765aa8e },
+	{ 0xba6b0bcdccafcdb9, 0x44a8a0032ed818d2, 0xaa9d235a2fa980cc, 0x3b425d46fc38347a, 0xe94e24ee139d40ba, 0x6280a8cd48d6873d, 0x5819c93d2b25a805, 0xc01b6cc9b3c0ce27, 0x0352a05d2db66dec, 0xc1ffa65f3ac52604, 0x75c142cc606452d5, 0xf8917bcfe760cb5e },
+	{ 0x086d63ff4ff4aa53, 0x8b053f32562dab2a, 0xeaebcf163140f995, 0xf85cc1d1a9025a30, 0x72b147b57e01f41a, 0x24ce8b5f49ced6bd, 0x086dc250cb162541, 0xa4160b2f09fb7789, 0xd2c18c87152872bf, 0x15cf20ce54586f6b, 0x78f9673f3a6e1ef0, 0x527b559ee7b50246 },
+	{ 0x9e21935ec5640ce6, 0xdea874d3f137c378, 0xf6d961ccea0c32fb, 0xbb6f801d16bce7c0, 0x429d8f6d002a396d, 0x0e552045e9a37cfb, 0xeb424061012ccfbc, 0x6576235e71cf0165, 0x7b2c310ab769195c, 0x9876d6cb5685a816, 0x8272dd00870881bd, 0xf4c3ba333bbb657f },
+	{ 0xeb3123dfa3babe4e, 0xafaa09a69a754640, 0x5e785936a7e2b144, 0x41c89f94217caf76, 0x164a21d122cefe90, 0x19b2b504d65b9a90, 0x5521b1de3a7ef85d, 0x6ccf06c458c2f029, 0x67d881e4fd53635c, 0x54da6c2d25fc20c9, 0x0107d9d386cf26a0, 0x82dab03dde526de3 },
+	{ 0x3cba7d3d5f70752b, 0x6e53085d0a790ae1, 0xb73866ce3d3dc333, 0xe6f37f6e2f13c296, 0x7cdb1b66143b4a4b, 0xb0a4f7032ebf11f1, 0x929229c1827c3751, 0x8e49fbbadfca7ad9, 0x685af748ada916d3, 0x5107529c361c0656, 0xf2d3ad976d5bc496, 0xd47f702f5dcaf4a7 },
+	{ 0x0ccbb2d69abea24c, 0xaa45d0d767b32e15, 0x085edd1ef9e3cb39, 0x9de536dfd97adcdb, 0x8b2714d5439f34da, 0x7b322a6c7b87586e, 0xb21e032afa438797, 0xa315de5461d74953, 0x031ccc58ec8ef80c, 0xc442e2b3b47c42ba, 0x3c4cba49e0f15371, 0xef1d36a13463a562 },
+	{ 0xa63ba10fd6596367, 0x19670f6335573a3f, 0x718fb122ea78303c, 0x25d9700aaa67ccce, 0x57265a065530413d, 0xd8315482789751a9, 0x7dbe2f82ba816cbe, 0x137416ce8d79e3d4, 0x75c106c93b65c667, 0x6d9900bd620d021d, 0xdeadec1aafb92c76, 0x738c10bc4a38e100 },
+	{ 0x69988023f3ff169a, 0xa275b38931a0e5fb, 0x1544b7b130a961f6, 0xd954ec0f8fed5860, 0x915ad7086eb26412, 0xccc8dfd9d51f1097, 0x73ed7dc2715a32ad, 0x96d61ed70630fd6c, 0x98fc70274b095fc1, 0x586fe4c6d15b6bc7, 0x2b20959949f372df, 0x25953f2a17100dba },
+	{ 0xdbd7e41697b6d48b, 0x0faaaf4c91000cf6, 0x0cb5aa0e1846e5ff, 0xa4b5ec6d542ea543, 0xbc1a58abae4b4826, 0x9baf554f70a681d5, 0x68d54d3fda5e8695, 0x0e84e308ef1240fe, 0x27c585e3e75fffe1, 0x2f0e2ae68e59ca82, 0x49e5c51ccee48780, 0xd32f05355ae3d39e },
+	{ 0x56c5f8a8109ae82e, 0x5a44e141eed49fdb, 0x396b2d1734071418, 0xe2b99b43d1d4c467, 0x83a15ccb9d908b80, 0xcba79e452f1e72e5, 0x09fe8c06b1f5cbeb, 0x23e5430e7c3e7fd5, 0xd07e4e41b81f457f, 0x04baa30133da8ece, 0xfaa20735cbf7170f, 0x4a03af672e7cb74b },
+	{ 0x7c846e5d17c45f45, 0x18203fe3a4a750a8, 0xf9b9f16c9ac803a2, 0x0faa5777367be08b, 0xfa9cf6309a04d2a7, 0x29fbf09241ca6ec9, 0x04dcd857ae2c549f, 0x4fc4324828277f99, 0xca2d659f42a243d6, 0x534ea1d03ce99ccd, 0xa5dfa2ace13c90b0, 0x80cde3bb1232a42d },
+	{ 0x31f8456e1898cc5b, 0x137702921d64d4a6, 0xf33cd69fcf49ffbd, 0x97794adab09a3c8e, 0xbfeff78b607ba71b, 0xb596bb7920a4b5c4, 0xac6cc0a75d8a8bc0, 0xc159379dad60f5ed, 0xb757807a08e20add, 0x4f8a3c086dc0cac4, 0xe09b18e82547fdd2, 0x095bdae8df4420ad },
+	{ 0x268717ac49874878, 0x67b967a810aeb3d7, 0x4258f373022ef160, 0x52641d8cbd6117fb, 0x80b67067325fdc74, 0xc1e8ba9848c17dbf, 0xe6e79ade68b1a1a6, 0x3df96d816ce1db14, 0x9b7481a4ef91d5df, 0x88cc5d68bc2d2920, 0x9d8fa5405b917d1b, 0xebcc2364fba96b93 },
+	{ 0x7030c994803137b6, 0x9fdd4e8f718c6371, 0xa5134874e9795bdf, 0x194629999a60789f, 0xde6c2c463efecb64, 0x884568fa9a2e632a, 0x5c7d3ca3af555940, 0xfe5a61bbc47b4400, 0xf773545fa22a691b, 0xb55cd1e3b9f8d663, 0xe27dd63909b43f81, 0x9618205c48ae681d },
+	{ 0xe75b2a5d4e0ce8d7, 0x4bb350b90233e21e, 0xd9d2f53ad607a270, 0x513315c8bd72393e, 0x8e5a877e11d8cf7e, 0xcf40a5ea3d3fd248, 0xa529e7bf34a327fe, 0xd0dc1f11e6eb5e08, 0xd0ff1356053c17e6, 0x94d7d72321b9bbe7, 0xc0924ca9df80631d, 0x0855f2399c14df5f },
+	{ 0x2b4e1d06f4736d68, 0xf42f6a7afee6f1f0, 0x508779990b8b6693, 0x1457d2dc4a614017, 0xc2da2754eb4ae7d1, 0x27f7272c077e3f77, 0x0f72109b9519ea63, 0x1b077d6de48e303d, 0x8ce7e7d46e7ee5c2, 0x3cc3ca34d08ac686, 0x2129aaf0d912d874, 0x28308a2eec19d148 },
+	{ 0x5ffef8abb747a8cd, 0x843e288be2dca098, 0x3f69da04812dd2ec, 0x6f60e7775281c3b3, 0xa0d1de0e8c24a56b, 0x4f89e0ad9f55586d, 0x7d26f9eaa8c2580e, 0xfe1e816a673772aa, 0xac17a0c3a8f4d6c5, 0xb97e9886176d631a, 0x19a7fd6f28aa02c6, 0x8bbf644852ba768d },
+	{ 0xed5e4aee53691cf2, 0xa36220006d6ee46c, 0xd200105253c2b288, 0x064cbd1b48b3d8c2, 0x774127745d8a74a2, 0x3a07570af0bfe926, 0x6c612897994c9355, 0x25bc1da1ae8a0b4c, 0xd3e6861eebc09e4b, 0x6d62e9157794b606, 0x4f0e491153a18723, 0x61435ebc470eccda },
+	{ 0xba5cb07406404397, 0xe8597ee2b6310a37, 0x6a714e4dd6748483, 0xb1ad0c282bac5913, 0xcb9f0a6eaf75c954, 0xa8b2397865ec4463, 0x1d1b58884af6c0a0, 0x37a5a83a79cd5b0e, 0x57dc6bf6df1b3089, 0xbd9b0e78d7f0b72f, 0xa7ae4330c0310f2e, 0xd90b4b0379779385 },
+	{ 0xdf3bc01d7b14ed2f, 0xe210848ad0ecd322, 0xdc11d92a86c823f7, 0xf3e8eed6c03c6704, 0xf73dc4032fb9f190, 0xf93760653f749f9e, 0x39459cd8770f9f02, 0x2fe8ba786819abe4, 0xb6414a91897acacb, 0x70841e5332abc34e, 0x8993e8cade3a21a1, 0xd39b1702bf75c01a },
+	{ 0x5f1bcf809b83d23f, 0x2df1b191ee7205e9, 0x1b406fcbc75c56a0, 0xe76d9ef036b51c3d, 0xce5829d3b2340e2e, 0x7db043390eef24d4, 0xe14673adb768e849, 0x6a2bc7632640ba6c, 0x09699ed11cf1d66e, 0xfa821df5a3630c0d, 0x3923a446cbf167c3, 0x372fb463f17b30dc },
+	{ 0x3f81bb9fbe4553da, 0xede17017e2c192c5, 0xe99272fcd6697d37, 0xad032667ec93e536, 0xe5c3e9c2d4e3844f, 0xc316e96dc98852dc, 0x0e4a400e9ca8a7e0, 0x2e0e3348ce360a6d, 0x4fdec93f2d8467ef, 0x72a3b1065d07781f, 0x9f70ba0f0792d7ac, 0x84256a8a7ced0342 },
+	{ 0x5e882d16e9425d4c, 0xf4f8858c371fc11d, 0x17e3006ae8ed7cd0, 0x91b9447db96fa6d3, 0xda90ccc5ad394854, 0x42bbead703cf3e8b, 0x2583eef30b01c41c, 0x892c2b23521b1eba, 0x4e038191c93e4214, 0x62e2299ce69c0805, 0x0a6a951ac1bfbcdc, 0x681957552a017046 },
+	{ 0xeb0d82fd8aeb7ef2, 0xd1aa30c16b31682b, 0x87af1721b8d788f9, 0xdbb0559f75ee8f6f, 0x5060e34458f5da87, 0x7321743c5a322030, 0x7c323c15759726bb, 0xa2a86f0ba60c9043, 0x45ed143c437d37e5, 0xe14d873a1ce8a7c0, 0x15a2252c91d3f334, 0x727e0249a0dffacb },
+	{ 0xd38d1e5a9c28a468, 0x3b2b9936c23ac6a9, 0xd691853c9c7e6d84, 0xaa10b4036726236a, 0x6b58049a954b5ed5, 0xb672ebc42c168f53, 0xffef02fbba564141, 0xd8f7a74a7ed71a06, 0x6c5b2ee31982fe32, 0xc8d210815047fbc1, 0x4fc2e0bbd2f8dd42, 0xcda127d27133e6eb },
+	{ 0xd96d850131c70587, 0xb675484b47810cfc, 0x8aaf43d4339ab071, 0x71618ad53cf14ffa, 0xd9014d0f21b7c03b, 0xfb810da1400ab568, 0x42a4aa8b8b165e47, 0x9fe1ec8a45579757, 0x72d83bca30ebf0c4, 0xb034a22caf1e29ee, 0x1dad15a9e52d4bf1, 0x64aa7926a7cd1437 },
+	{ 0x1f86d596c89d89d4, 0x01a9e1d652fc14cf, 0x86b63490a7ec0de7, 0xc7b9eb17bc321120, 0x3cb356eb84c1be21, 0x6158fbad22bee25b, 0xed81eaa585b16a05, 0x3a815f66c4290fee, 0x4a37ad89ad372d63, 0x815dcb1cbc980af1, 0xde7c18bc32180cb8, 0x9cf091404f6ba7cb },
+	{ 0x1401ac4c320cfa46, 0x82ae23365fe0848e, 0xdaee07481d5bf977, 0x0450ff2e5270bd0a, 0x8ff7d73cf53a5984, 0xd552d513856b3037, 0x909258be93220cab, 0xf5d06873a5556bd7, 0x47ae2f9f3af13c63, 0x7523b86143537245, 0xfdf89c6bb2e59d85, 0x03a2af636a9da927 },
+	{ 0x9c01f4f5651cb0e5, 0x86d7c14ce41f165c, 0x367e16461d7119e5, 0xf0a021201a219bc4, 0x9b6d9d6078651967, 0x033e75239c14d5a1, 0xe9b8dc601081ad08, 0x32fd2381c979c1ee, 0x8446168decb18cc9, 0x052c04e66b916e53, 0x781a7fc23138db76, 0x228756c7ee232aed },
 };
 
+uint64_t zobristBlackToMove = 0x3ddad07f283ae0ff;
+
+// Placement only: the in-memory table is keyed by the 32-byte board
+// encoding, which has no room for the side to move.
 uint64_t BoardHash::operator()(const Board& board) const
 {
 	const char* boardRepresentation = board.representation();
@@ -84,3 +90,24 @@ uint64_t BoardHash::operator()(const Board& board) const
 
 	return hash;
 }
+
+// Shards are contiguous key ranges of equal width, so shard files built
+// separately are already disjoint, ordered slices of the key space.
+uint32_t keyShard(uint64_t key, uint32_t shards)
+{
+	return static_cast<uint32_t>(key / (UINT64_MAX / shards + 1));
+}
+
+// Book key for the block formats; includes the side to move so that a
+// 64-bit key alone identifies the position.
+uint64_t zobristKey(const Board& board)
+{
+	uint64_t key = BoardHash()(board);
+
+	if (!board.whiteToMove())
+	{
+		key ^= zobristBlackToMove;
+	}
+
+	return key;
+}
\ No newline at end of file
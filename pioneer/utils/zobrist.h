@@ -7,4 +7,7 @@ class BoardHash
 {
 public:
 	uint64_t operator()(const Board& board) const;
-};
\ No newline at end of file
+};
+
+uint64_t zobristKey(const Board& board);
+uint32_t keyShard(uint64_t key, uint32_t shards);
\ No newline at end of file